@@ -1,62 +1,93 @@
 module chu_vga_sprite_doodle_core 
    #(parameter CD = 12,   // color depth
-               ADDR_WIDTH = 10,
-               KEY_COLOR = 0
+               ADDR_WIDTH = 13,  // four 32x64 sprites
+               KEY_COLOR = 0,
+               INIT_FILE = "doodle_bitmap.txt"   // sprite bitmap
    )
    (
     input  logic clk, reset,
     // frame counter
     input logic [10:0] x, y,
+    input logic frame_start,
     // video slot interface
     input  logic cs,      
     input  logic write,  
     input  logic [13:0] addr,    
     input  logic [31:0] wr_data,
+    output logic [31:0] rd_data,
     // stream interface
     input  logic [11:0] si_rgb,
     output logic [11:0] so_rgb
    );
 
    // delaration
-   logic wr_en, wr_ram, wr_reg, wr_ctrl, wr_bypass, wr_x0, wr_y0;
+   logic wr_en, wr_ram, wr_reg, wr_ctrl, wr_bypass, wr_x0, wr_y0, wr_xyc;
    logic [CD-1:0] sprite_rgb, chrom_rgb;
    logic [10:0] x0_reg, y0_reg;
-   logic [4:0] ctrl_reg;
+   logic [5:0] ctrl_reg;
+   logic [10:0] x0_shadow_reg, y0_shadow_reg;
+   logic [5:0] ctrl_shadow_reg;
    logic bypass_reg;
+   logic frame_start_d1_reg, frame_tick;
+   logic [31:0] frame_cnt_reg;
 
    // body
    // instantiate sprite generator
-   doodle_src #(.CD(12), .ADDR(11), .KEY_COLOR(0)) doodle_src_unit (    // Set address to doodle_src for 11, to accomodate for larger sprite
+   doodle_src #(.CD(12), .ADDR(ADDR_WIDTH), .KEY_COLOR(0), .INIT_FILE(INIT_FILE)) doodle_src_unit (    // 13 address bits hold four 32x64 sprites
        .clk(clk), .x(x), .y(y), .x0(x0_reg), .y0(y0_reg),
        .ctrl(ctrl_reg), .we(wr_ram), .addr_w(addr[ADDR_WIDTH-1:0]),
        .pixel_in(wr_data[1:0]), .sprite_rgb(sprite_rgb));
        
    // register  
+   // x0/y0/ctrl writes go to shadow registers, which are committed
+   // together once per frame so the sprite never tears mid-scan
    always_ff @(posedge clk, posedge reset)
       if (reset) begin
          x0_reg <= 0;
          y0_reg <= 0;
+         x0_shadow_reg <= 0;
+         y0_shadow_reg <= 0;
          bypass_reg <= 0;
-         ctrl_reg <= 5'b00100;  // red animation
+         ctrl_reg <= 6'b000100;  // red animation
+         ctrl_shadow_reg <= 6'b000100;
+         frame_start_d1_reg <= 0;
+         frame_cnt_reg <= 0;
       end   
       else begin
          if (wr_x0)
-            x0_reg <= wr_data[10:0];
+            x0_shadow_reg <= wr_data[10:0];
          if (wr_y0)
-            y0_reg <= wr_data[10:0];
+            y0_shadow_reg <= wr_data[10:0];
          if (wr_bypass)
             bypass_reg <= wr_data[0];
          if (wr_ctrl)
-            ctrl_reg <= wr_data[4:0];
+            ctrl_shadow_reg <= wr_data[5:0];
+         if (wr_xyc) begin
+            x0_shadow_reg <= wr_data[10:0];
+            y0_shadow_reg <= wr_data[21:11];
+            ctrl_shadow_reg <= wr_data[27:22];
+         end
+         frame_start_d1_reg <= frame_start;
+         if (frame_tick) begin
+            x0_reg <= x0_shadow_reg;
+            y0_reg <= y0_shadow_reg;
+            ctrl_reg <= ctrl_shadow_reg;
+            frame_cnt_reg <= frame_cnt_reg + 1;
+         end
       end      
+   // one tick at the start of each frame 
+   assign frame_tick = frame_start && ~frame_start_d1_reg;
    // decoding 
    assign wr_en = write & cs;
    assign wr_ram = ~addr[13] && wr_en;
    assign wr_reg = addr[13] && wr_en;
-   assign wr_bypass = wr_reg && (addr[1:0]==2'b00);
-   assign wr_x0 = wr_reg && (addr[1:0]==2'b01);
-   assign wr_y0 = wr_reg && (addr[1:0]==2'b10);
-   assign wr_ctrl = wr_reg && (addr[1:0]==2'b11);
+   assign wr_bypass = wr_reg && (addr[2:0]==3'b000);
+   assign wr_x0 = wr_reg && (addr[2:0]==3'b001);
+   assign wr_y0 = wr_reg && (addr[2:0]==3'b010);
+   assign wr_ctrl = wr_reg && (addr[2:0]==3'b011);
+   assign wr_xyc = wr_reg && (addr[2:0]==3'b100);   // x, y and ctrl in one write
+   // read out frame counter, only from the register at 0x2000
+   assign rd_data = (cs && addr[13] && (addr[2:0]==3'b000)) ? frame_cnt_reg : 32'h0;
    // chrome-key blending and multiplexing
    assign chrom_rgb = (sprite_rgb != KEY_COLOR) ? sprite_rgb : si_rgb;
    assign so_rgb = (bypass_reg) ? si_rgb : chrom_rgb;
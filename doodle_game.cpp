@@ -24,6 +24,14 @@
 #define Y_REFERENCE 4		// Y coordinate reference the screen focuses on
 #define XADC_REFERENCE 0.5	// XADC reference that is the median value
 #define XADC_OFFSET 0.3		// XADC offset which determines direction
+#define SPRITE_JUMP 0		// Sprite frame while jumping
+#define SPRITE_FALL 1		// Sprite frame while falling
+#define SPRITE_LAND 2		// Sprite frame right after landing
+#define SPRITE_AUTO 0x04	// Sprite ctrl bit that cycles through all frames
+#define SPRITE_MIRROR 0x20	// Sprite ctrl bit that mirrors the sprite to face left
+#define LAND_STEPS 8		// Number of jump steps the landing frame is shown for
+#define REPLAY_SEED 4305	// Platform generator seed unattended games start from
+#define FRAME_US 16800		// One 800x525 frame at the 25 MHz pixel clock, in microseconds
 
 // Global variables
 int platform_location[NUM_HORIZ_LINES * 2][NUM_VERT_LINES];	// Platform array, store an extra "screen" of values
@@ -32,7 +40,942 @@ int square_height;			// Coordinate square height, determined by (height of scree
 int character_x;			// Character current x position
 int character_y;			// Character current y position
 int score = 0;				// Score
+int background_drawn = 0;	// Set once the background grid is on the frame buffer
+int keyboard_checked = 0;	// Set once Ps2Core::init() has looked for the keyboard
+unsigned int platform_seed = 1;	// Platform generator state
 
+/**
+ * Seed the platform generator
+ *
+ * @param: seed unsigned integer saying the new state
+ */
+
+void platform_srand(unsigned int seed)
+{
+	platform_seed = seed;
+}
+
+/**
+ * Random number for the platform layout
+ *
+ * @return: integer from 0 to 32767
+ *
+ * @note: The same linear congruential step on every toolchain,
+ * 		unlike rand(), so a seeded map is identical on the board
+ * 		and in a host build
+ */
+
+int platform_rand()
+{
+	platform_seed = platform_seed * 1103515245u + 12345u;
+	return (platform_seed >> 16) & 0x7FFF;
+}
+
+#ifdef _DEBUG
+// Performance phases, MMIO writes are charged to whichever phase is active
+#define PHASE_GRID 0		// Full background repaint
+#define PHASE_DRAW 1		// Platform squares drawn
+#define PHASE_RESTORE 2		// Platform squares restored to background
+#define PHASE_STEP 3		// One jump/fall step (sprite update)
+#define PHASE_SCORE 4		// OSD score drawn, one unit per character and one for the bypass
+#define NUM_PHASES 5
+
+struct perf_phase_t {
+	const char *name;		// Name printed over UART
+	int budget;				// Maximum MMIO writes allowed per unit of work
+	int us_budget;			// Maximum wall time allowed per unit of work, in microseconds
+	int units;				// Units of work done (screens, squares, steps)
+	unsigned long writes;	// MMIO writes issued
+	unsigned long us;		// Wall time spent, in microseconds
+};
+
+// Budgets are the current cost of each renderer. The GRID, DRAW and RESTORE
+// write budgets are exact, so any extra write fails. Lower them together with
+// the renderer whenever it is optimized, so the old cost becomes a failure.
+// @note: SCORE counts a unit per character it draws, so its budget follows
+//		the number of digits in the score
+// @note: Time budgets allow 25% over WRITE_NS per write, so a renderer that
+//		spends more time per write fails. The STEP budget also covers the
+//		software floating point of the XADC steering, and SCORE the sprintf
+#define WRITE_NS 250		// Time of one wr_pix() in a loop on the board, in nanoseconds, also charged per bus access by sim/host_model.cpp
+#define WRITE_US_BUDGET(writes) ((writes) * WRITE_NS * 5 / 4 / 1000)
+
+perf_phase_t perf[NUM_PHASES] = {
+	{"GRID", (NUM_VERT_LINES * 480) + (NUM_HORIZ_LINES * 640) + (640 * 480), WRITE_US_BUDGET(326400), 0, 0, 0},
+	{"DRAW", 32 * 32, WRITE_US_BUDGET(1024), 0, 0, 0},
+	{"RESTORE", (32 * 32) + 32, WRITE_US_BUDGET(1056), 0, 0, 0},
+	{"STEP", 1, 2000, 0, 0, 0},
+	{"SCORE", 1, 10, 0, 0, 0}
+};
+int perf_current = -1;			// Active phase, -1 if none
+unsigned long perf_start;		// Time the active phase was (re)entered
+unsigned int perf_hash = 0;		// Sum of the hashes of every value written to the screen
+
+/**
+ * Enter a performance phase, pausing the time of the
+ * phase that was active
+ *
+ * @param: phase integer saying the phase to enter
+ *
+ * @return: the previously active phase, to be passed
+ * 		to perf_end
+ */
+
+int perf_begin(int phase)
+{
+	int previous = perf_current;
+	unsigned long now = now_us();
+
+	if(previous >= 0)
+		perf[previous].us += now - perf_start;
+
+	perf[phase].units++;
+	perf_current = phase;
+	perf_start = now;
+
+	return previous;
+}
+
+/**
+ * Leave the active performance phase and resume the
+ * previously active one
+ *
+ * @param: previous integer returned by perf_begin
+ */
+
+void perf_end(int previous)
+{
+	unsigned long now = now_us();
+
+	perf[perf_current].us += now - perf_start;
+	perf_current = previous;
+	perf_start = now;
+}
+
+/**
+ * Charge MMIO writes to the active performance phase
+ *
+ * @param: n integer saying the number of bus writes
+ */
+
+void perf_count(int n)
+{
+	if(perf_current >= 0)
+		perf[perf_current].writes += n;
+}
+
+/**
+ * Add units of work to the active performance phase, for
+ * phases whose work varies from one call to the next
+ *
+ * @param: n integer saying the extra units
+ */
+
+void perf_units(int n)
+{
+	if(perf_current >= 0)
+		perf[perf_current].units += n;
+}
+
+/**
+ * Fold a screen write into the running hash
+ *
+ * @param: x integer saying the x pixel or tile
+ * @param: y integer saying the y pixel or tile
+ * @param: value integer saying the color, character or ctrl written
+ *
+ * @note: Each write is hashed on its own and added, so the
+ * 		order the writes are issued in does not matter
+ */
+
+void perf_fold(int x, int y, int value)
+{
+	unsigned int hash = 2166136261u;
+
+	hash = (hash ^ x) * 16777619u;
+	hash = (hash ^ y) * 16777619u;
+	hash = (hash ^ value) * 16777619u;
+	perf_hash += hash ^ (hash >> 15);
+}
+
+/**
+ * Debug method to hash everything written to the frame
+ * buffer, the OSD and the sprite since power on
+ *
+ * @return: 32-bit sum of the FNV-1a hashes of the writes
+ *
+ * @note: Unattended sources reseed the platform generator,
+ * 		so a run with the same inputs always produces the same
+ * 		hash. A renderer that writes the same values in another
+ * 		order keeps it, one that adds or drops writes does not,
+ * 		even if the screen ends up the same. The host suite in
+ * 		sim/ checks the screen itself
+ */
+
+unsigned int state_hash()
+{
+	return perf_hash;
+}
+
+/**
+ * Debug method to check every performance phase against its
+ * write and time budgets, printing the phases that are over
+ *
+ * @return: 1 if all phases are within budget, 0 otherwise
+ */
+
+int perf_check()
+{
+	int pass = 1;
+
+	for(int i = 0; i < NUM_PHASES; i++)
+	{
+		if(perf[i].writes > (unsigned long) perf[i].units * perf[i].budget ||
+				perf[i].us > (unsigned long) perf[i].units * perf[i].us_budget)
+		{
+			uart.disp(perf[i].name);
+			uart.disp(" OVER BUDGET\n\r");
+			pass = 0;
+		}
+	}
+
+	return pass;
+}
+
+#ifndef REGRESSION_HALT
+#define REGRESSION_HALT() while(1)	// Stop the game so the failure is noticed
+#endif
+
+/**
+ * Debug method to stop the game when a regression is found
+ *
+ * @param: reason string printed over UART
+ */
+
+void regression_fail(const char *reason)
+{
+	uart.disp("REGRESSION FAILED: ");
+	uart.disp(reason);
+	uart.disp("\n\r");
+	REGRESSION_HALT();
+}
+
+#define PERF_BEGIN(phase) int perf_previous = perf_begin(phase)
+#define PERF_END() perf_end(perf_previous)
+#define PERF_COUNT(n) perf_count(n)
+#define PERF_UNITS(n) perf_units(n)
+#define PERF_HASH(x, y, value) perf_fold(x, y, value)
+#else
+#define PERF_BEGIN(phase)
+#define PERF_END()
+#define PERF_COUNT(n)
+#define PERF_UNITS(n)
+#define PERF_HASH(x, y, value)
+#endif
+
+// Input latency sources
+#define LATENCY_STEER 0		// Steering sample until the frame that shows the move starts
+#define LATENCY_KEY 1		// Key code drained from the PS/2 FIFO until the OSD shows its effect
+#define NUM_LATENCY 2
+#define LATENCY_SAMPLES 128	// Number of most recent samples kept per source
+
+unsigned long latency_samples[NUM_LATENCY][LATENCY_SAMPLES];	// Ring buffer of latencies in microseconds
+int latency_count[NUM_LATENCY];									// Total samples recorded per source
+
+/**
+ * Record the latency of an input event, from the time the
+ * input was taken until now, when its effect was written
+ *
+ * @param: source integer saying the latency source
+ * @param: start_us unsigned long saying the now_us() time
+ * 		the input was taken
+ */
+
+void latency_record(int source, unsigned long start_us)
+{
+	latency_samples[source][latency_count[source] % LATENCY_SAMPLES] = now_us() - start_us;
+	latency_count[source]++;
+}
+
+/**
+ * Calculate a percentile of the most recent latencies of
+ * an input source
+ *
+ * @param: source integer saying the latency source
+ * @param: percent integer saying the percentile, 0 to 100
+ *
+ * @return: the latency in microseconds, 0 if nothing has
+ * 		been recorded
+ */
+
+unsigned long latency_percentile(int source, int percent)
+{
+	unsigned long sorted[LATENCY_SAMPLES];
+	int n = latency_count[source];
+
+	if(n == 0)
+		return 0;
+	if(n > LATENCY_SAMPLES)
+		n = LATENCY_SAMPLES;
+
+	// Insertion sort a copy, the ring buffer is small
+	for(int i = 0; i < n; i++)
+	{
+		unsigned long sample = latency_samples[source][i];
+		int j = i;
+
+		while(j > 0 && sorted[j - 1] > sample)
+		{
+			sorted[j] = sorted[j - 1];
+			j--;
+		}
+		sorted[j] = sample;
+	}
+
+	return sorted[((n - 1) * percent) / 100];
+}
+
+/**
+ * Driver for the doodle sprite core, adding the registers
+ * the standard SpriteCore does not have
+ *
+ * @note: The core latches x, y and ctrl writes and commits
+ * 		them together at the start of the next frame, so
+ * 		the sprite never tears mid-scan
+ */
+
+class DoodleCore : public SpriteCore {
+public:
+	enum {
+		FRAME_REG = 0x2000,		// Frame counter, read only
+		XYC_REG = 0x2004		// x in bits [10:0], y in [21:11] and ctrl in [27:22]
+	};
+
+	DoodleCore(uint32_t core_base_addr, int sprite_size) :
+		SpriteCore(core_base_addr, sprite_size), base_addr(core_base_addr), ctrl(0x04) {}
+
+	// Queue x, y and ctrl as one bus write
+	void move_xyc(int x, int y, int ctrl)
+	{
+		this -> ctrl = ctrl;
+		io_write(base_addr, XYC_REG, (x & 0x7FF) | ((y & 0x7FF) << 11) | ((ctrl & 0x3F) << 22));
+	}
+
+	// Queue x and y as one bus write, keeping the current ctrl
+	void move_xy(int x, int y) { move_xyc(x, y, ctrl); }
+
+	// Number of frames shown since reset
+	uint32_t frame_count() { return io_read(base_addr, FRAME_REG); }
+
+	// Wait for a number of frames to start, calling poll while waiting
+	// @note: Falls back to timing FRAME_US per frame if the
+	//		counter does not advance
+	void frame_wait(int frames, void (*poll)() = 0)
+	{
+		uint32_t start = frame_count();
+		unsigned long start_us = now_us();
+
+		while(frame_count() - start < (uint32_t) frames)
+		{
+			if(poll)
+				poll();
+			if(now_us() - start_us > (unsigned long) frames * FRAME_US)
+				return;
+		}
+	}
+
+private:
+	uint32_t base_addr;
+	int ctrl;			// Last ctrl value written
+};
+
+/**
+ * Write a pixel to the frame buffer, counting the
+ * bus write
+ *
+ * @param: frame_p FrameCore pointer
+ * @param: x integer saying the x pixel
+ * @param: y integer saying the y pixel
+ * @param: color integer saying the 9-bit color
+ */
+
+inline void pix_write(FrameCore *frame_p, int x, int y, int color)
+{
+	PERF_COUNT(1);
+	PERF_HASH(x, y, color);
+	frame_p -> wr_pix(x, y, color);
+}
+
+/**
+ * Write a character to the OSD, counting the bus write
+ *
+ * @param: osd_p OsdCore pointer
+ * @param: x integer saying the x tile
+ * @param: y integer saying the y tile
+ * @param: ch character to be written
+ * @param: reverse integer, 1 for reversed colors
+ */
+
+inline void char_write(OsdCore *osd_p, int x, int y, char ch, int reverse = 0)
+{
+	PERF_COUNT(1);
+	PERF_HASH(x, y, (ch << 1) | reverse);
+	osd_p -> wr_char(x, y, ch, reverse);
+}
+
+/**
+ * Move the sprite and set its frame, counting the bus write
+ *
+ * @param: sprite_p DoodleCore pointer
+ * @param: x integer saying the x pixel
+ * @param: y integer saying the y pixel
+ * @param: ctrl integer saying the sprite frame and flags
+ */
+
+inline void sprite_move(DoodleCore *sprite_p, int x, int y, int ctrl)
+{
+	PERF_COUNT(1);
+	PERF_HASH(x, y, ctrl);
+	sprite_p -> move_xyc(x, y, ctrl);
+}
+
+// Steering samples whose sprite move is not shown yet
+#define STEER_PENDING 4		// Samples held, moves are 10 ms apart so at most 2 share a frame
+
+unsigned long steer_pending_us[STEER_PENDING];	// now_us() time of each held sample
+int steer_pending = 0;							// Number of held samples
+uint32_t steer_frame;							// Frame count when they were written
+unsigned long steer_written_us;					// now_us() time the first was written
+DoodleCore *steer_sprite_p;						// Sprite core they were written to
+
+/**
+ * Hold a steering sample until the sprite core shows the move
+ * it produced. The core commits moves at the start of a frame,
+ * so the latency runs until the frame counter advances
+ *
+ * @param: sprite_p DoodleCore pointer the move was written to
+ * @param: sample_us unsigned long saying the now_us() time
+ * 		the steering was sampled
+ */
+
+void steer_written(DoodleCore *sprite_p, unsigned long sample_us)
+{
+	if(steer_pending == 0)
+	{
+		steer_frame = sprite_p -> frame_count();
+		steer_written_us = now_us();
+		steer_sprite_p = sprite_p;
+	}
+
+	if(steer_pending < STEER_PENDING)
+		steer_pending_us[steer_pending++] = sample_us;
+}
+
+/**
+ * Record the held steering samples once the frame that shows
+ * them has started
+ *
+ * @note: Falls back to FRAME_US after the write if the frame
+ * 		counter does not advance, the longest a move can wait
+ */
+
+void steer_poll()
+{
+	if(steer_pending == 0)
+		return;
+
+	if(steer_sprite_p -> frame_count() != steer_frame || now_us() - steer_written_us > FRAME_US)
+	{
+		for(int i = 0; i < steer_pending; i++)
+			latency_record(LATENCY_STEER, steer_pending_us[i]);
+		steer_pending = 0;
+	}
+}
+
+// Keyboard event queue
+#define KEY_QUEUE_SIZE 32	// Number of queued key events, must be a power of two
+#define KEY_LEFT 0x01		// Key code for the left arrow
+#define KEY_RIGHT 0x02		// Key code for the right arrow
+
+struct key_event_t {
+	char ch;				// Key, lowercase ASCII or KEY_LEFT/KEY_RIGHT
+	char make;				// 1 if pressed, 0 if released
+	unsigned long us;		// now_us() time the first byte of the key code was drained
+};
+
+// Single-producer/single-consumer ring, ps2_isr() only writes key_head
+// and the game only writes key_tail, so no locking is needed
+volatile key_event_t key_queue[KEY_QUEUE_SIZE];
+volatile unsigned int key_head = 0;
+volatile unsigned int key_tail = 0;
+volatile char key_held[128];		// 1 while a key is held down, indexed by key
+unsigned long key_arrival_us;		// Arrival time of the last key returned by key_get
+Ps2Core *key_ps2_p = 0;				// Keyboard feeding the queue, 0 until connected
+
+/**
+ * Translate a set 2 scan code into a key
+ *
+ * @param: code integer saying the scan code
+ * @param: extended integer, 1 if the code had an E0 prefix
+ *
+ * @return: the key, 0 if the key is not used by the game
+ */
+
+char key_translate(int code, int extended)
+{
+	const int scan_codes[] = {
+		0x1C, 0x32, 0x21, 0x23, 0x24, 0x2B, 0x34, 0x33, 0x43, 0x3B, 0x42, 0x4B, 0x3A,
+		0x31, 0x44, 0x4D, 0x15, 0x2D, 0x1B, 0x2C, 0x3C, 0x2A, 0x1D, 0x22, 0x35, 0x1A
+	};
+
+	if(extended)
+	{
+		if(code == 0x6B)
+			return KEY_LEFT;
+		if(code == 0x74)
+			return KEY_RIGHT;
+		return 0;
+	}
+
+	for(int i = 0; i < 26; i++)
+	{
+		if(scan_codes[i] == code)
+			return 'a' + i;
+	}
+
+	return 0;
+}
+
+/**
+ * Keyboard interrupt handler, the producer of the key queue.
+ * Drains the PS/2 receive FIFO, tracks held keys and queues
+ * every press and release
+ *
+ * @note: This SoC does not route a PS/2 interrupt, so the
+ * 		handler is run from input_poll(), while the game would
+ * 		otherwise be sleeping, between squares and grid lines
+ * 		of the redraws and during the death animation. The
+ * 		longest stretch between calls, and so the longest a
+ * 		key code waits in the FIFO, is an OSD clr_screen and
+ * 		its message (about 2500 writes). The exception is the
+ * 		first game's frame clr_screen while the title is up.
+ * 		It is safe to attach to a real interrupt as long as
+ * 		those calls are removed
+ * @note: Events are dropped if the queue is full
+ */
+
+void ps2_isr()
+{
+	static int released = 0;	// F0 break prefix was received
+	static int extended = 0;	// E0 extended prefix was received
+	static unsigned long first_us;	// Time the first byte of the current code was drained
+	int code;
+
+	if(key_ps2_p == 0)
+		return;
+
+	while((code = key_ps2_p -> rx_byte()) >= 0)
+	{
+		// Every byte read here was already waiting, so a key code is
+		// timed from the drain that found its first byte
+		if(!released && !extended)
+			first_us = now_us();
+
+		if(code == 0xF0)
+		{
+			released = 1;
+			continue;
+		}
+		if(code == 0xE0)
+		{
+			extended = 1;
+			continue;
+		}
+
+		char ch = key_translate(code, extended);
+		char make = !released;
+
+		released = 0;
+		extended = 0;
+
+		// Skip unused keys and the repeats sent while a key is held
+		if(ch == 0 || (make && key_held[(int) ch]))
+			continue;
+
+		key_held[(int) ch] = make;
+
+		if(key_head - key_tail < KEY_QUEUE_SIZE)
+		{
+			volatile key_event_t *event = &key_queue[key_head % KEY_QUEUE_SIZE];
+
+			event -> ch = ch;
+			event -> make = make;
+			event -> us = first_us;
+			key_head++;
+		}
+	}
+}
+
+/**
+ * Start feeding the key queue from a connected keyboard,
+ * clearing any old events and held keys
+ *
+ * @param: ps2_p Ps2Core pointer, 0 if no keyboard
+ */
+
+void key_queue_init(Ps2Core *ps2_p)
+{
+	key_ps2_p = 0;
+	key_tail = key_head;
+
+	for(int i = 0; i < 128; i++)
+		key_held[i] = 0;
+
+	key_ps2_p = ps2_p;
+}
+
+/**
+ * Check if the key queue has no events, without touching
+ * the keyboard
+ *
+ * @return: 1 if empty, 0 otherwise
+ */
+
+inline int key_empty()
+{
+	return key_head == key_tail;
+}
+
+/**
+ * Take the next key press from the key queue, the consumer
+ * side of the queue. Releases are skipped, they only update
+ * the held keys
+ *
+ * @param: ch character pointer the key is written to
+ *
+ * @return: 1 if a key press was taken, 0 otherwise
+ */
+
+int key_get(char *ch)
+{
+	while(!key_empty())
+	{
+		volatile key_event_t *event = &key_queue[key_tail % KEY_QUEUE_SIZE];
+		int make = event -> make;
+
+		*ch = event -> ch;
+		key_arrival_us = event -> us;
+		key_tail++;
+
+		if(make)
+			return 1;
+	}
+
+	return 0;
+}
+
+/**
+ * Check if a key is held down
+ *
+ * @param: ch character saying the key
+ *
+ * @return: 1 if held, 0 otherwise
+ */
+
+inline int key_down(char ch)
+{
+	return key_held[(int) ch];
+}
+
+/**
+ * Work that must keep running while the game is busy: the
+ * keyboard handler, so keys are queued as soon as they arrive,
+ * and the steering latency, so it ends as the frame starts
+ */
+
+void input_poll()
+{
+	ps2_isr();
+	steer_poll();
+}
+
+/**
+ * Wait for a number of milliseconds, polling the input
+ *
+ * @param: ms integer saying the time to wait
+ */
+
+void idle_wait(int ms)
+{
+	unsigned long start = now_us();
+
+	do {
+		input_poll();
+	} while(now_us() - start < (unsigned long) ms * 1000);
+}
+
+/**
+ * Source of the player's input, giving the steering
+ * direction each step and the keys pressed
+ */
+
+class InputSource {
+public:
+	virtual ~InputSource() {}
+
+	// Called at the start of every game
+	virtual void reset() {}
+
+	// Steering direction: -1 left, 0 none, 1 right
+	virtual int direction() = 0;
+
+	// Returns 1 and sets ch if a key was pressed, 0 otherwise
+	virtual int get_key(char *ch) { return key_get(ch); }
+
+	// Returns 1 if the source plays without a person, so
+	// the start and restart prompts are skipped
+	virtual int unattended() { return 0; }
+};
+
+/**
+ * Steering from the XADC voltage, keys from the key queue
+ */
+
+class XadcInput : public InputSource {
+public:
+	XadcInput(XadcCore *adc_p) : adc_p(adc_p) {}
+
+	int direction()
+	{
+		// Constants for calculating the movement using the XADC
+		// read_reference is the median value in the XADC read range
+		// read_offset is the offset for determining if the character moves
+		const double read_reference = XADC_REFERENCE;
+		const double read_offset = XADC_OFFSET;
+
+		double read_temp = adc_p -> read_adc_in(0);
+		double read_diff = read_reference - read_temp;
+
+		if(fabs(read_diff) <= read_offset)	// Within threshold, no direction is specified
+			return 0;
+
+		return (read_diff < 0) ? 1 : -1;	// Positive reading moves rightwards, negative leftwards
+	}
+
+private:
+	XadcCore *adc_p;
+};
+
+/**
+ * Steering and keys from the keyboard. 'A' or the left
+ * arrow steers left, 'D' or the right arrow steers right,
+ * the character stops when neither or both are held
+ */
+
+class KeyboardInput : public InputSource {
+public:
+	int direction()
+	{
+		int left = key_down('a') || key_down(KEY_LEFT);
+		int right = key_down('d') || key_down(KEY_RIGHT);
+
+		return right - left;
+	}
+};
+
+struct replay_event_t {
+	int step;			// Step the event happens on
+	int direction;		// Steering direction from this step on
+};
+
+struct replay_check_t {
+	int step;			// Steps replayed since power on, over every game
+	unsigned int hash;	// state_hash() of the known good run at that step
+};
+
+/**
+ * Scripted steering, played back step by step. Keys still
+ * come from the key queue so a replay can be paused
+ *
+ * @note: Every game reseeds the platform generator with
+ * 		REPLAY_SEED, so replaying the same script reproduces
+ * 		the same game
+ * @note: Debug builds compare state_hash() and the performance
+ * 		budgets against the known good run at each check, and
+ * 		stop the game on a mismatch
+ */
+
+class ReplayInput : public InputSource {
+public:
+	ReplayInput(const replay_event_t *script, int length, const replay_check_t *checks = 0, int num_checks = 0) :
+		script(script), length(length), step(0), next(0), steer(0),
+		checks(checks), num_checks(num_checks), played(0), check(0) {}
+
+	void reset()
+	{
+		step = 0;
+		next = 0;
+		steer = 0;
+		platform_srand(REPLAY_SEED);
+	}
+
+	int direction()
+	{
+		while(next < length && script[next].step <= step)
+			steer = script[next++].direction;
+
+#ifdef _DEBUG
+		if(check < num_checks && checks[check].step == played)
+		{
+			if(state_hash() != checks[check].hash)
+				regression_fail("STATE HASH");
+			if(!perf_check())
+				regression_fail("BUDGET");
+			check++;
+		}
+#endif
+
+		step++;
+		played++;
+		return steer;
+	}
+
+	int unattended() { return 1; }
+
+private:
+	const replay_event_t *script;
+	int length;
+	int step;		// Steps played so far this game
+	int next;		// Next event in the script
+	int steer;
+	const replay_check_t *checks;
+	int num_checks;
+	int played;		// Steps played over every game
+	int check;		// Next check
+};
+
+/**
+ * Steering that plays the game by itself, for long unattended
+ * runs. Keys still come from the key queue so it can be paused
+ *
+ * @note: Each step it plays out the rest of the jump holding
+ * 		each direction and takes the one that lands highest.
+ * 		When none lands above the platform it jumped from, it
+ * 		heads for the nearest platform above instead, even if
+ * 		that means dropping to a lower one first, as long as
+ * 		it does not fall out of bounds
+ * @note: Every game reseeds the platform generator with
+ * 		REPLAY_SEED, so runs are reproducible
+ */
+
+class AutopilotInput : public InputSource {
+public:
+	AutopilotInput() : last_y(0), rise(0), floor(0) {}
+
+	void reset()
+	{
+		platform_srand(REPLAY_SEED);
+		last_y = 0;
+		rise = 0;
+		floor = 0;
+	}
+
+	int direction()
+	{
+		// Jumps rise 2 pixels a step for 64 steps, count the steps left
+		if(character_y < last_y)
+			rise++;
+		else
+			rise = 0;
+		last_y = character_y;
+
+		// The jump started 2 pixels lower, on the row collision_check
+		// found under character_y + 4
+		if(rise == 1)
+			floor = (NUM_HORIZ_LINES - 1) - ((character_y + 4) / square_height) - 2;
+
+		int rest = (rise > 0) ? 64 - rise : 0;
+		int best = 0;
+		int best_row = landing(0, rest);
+
+		for(int direction = -1; direction <= 1; direction += 2)
+		{
+			int row = landing(direction, rest);
+
+			if(row > best_row)
+			{
+				best = direction;
+				best_row = row;
+			}
+		}
+
+		if(best_row > floor)
+			return best;
+
+		// No way up from here, line up under the nearest platform above
+		int target = -1;
+
+		for(int y = floor + 1; y <= floor + 4 && y < NUM_HORIZ_LINES * 2; y++)
+		{
+			for(int x = 0; x < NUM_VERT_LINES; x++)
+			{
+				if(platform_location[y][x] == 1 &&
+						(target < 0 || abs(x * square_width - character_x) < abs(target - character_x)))
+					target = x * square_width;
+			}
+		}
+
+		if(target < 0 || target == character_x)
+			return best;
+
+		int toward = (target > character_x) ? 1 : -1;
+
+		// Do not head for it off the bottom of the screen
+		if(landing(toward, rest) < 0)
+			return best;
+
+		return toward;
+	}
+
+	int unattended() { return 1; }
+
+private:
+	int last_y;		// character_y on the previous step
+	int rise;		// Steps risen so far in this jump, 0 while falling
+	int floor;		// Row of the platform the jump started from
+
+	int landing(int direction, int rest);
+};
+
+/**
+ * Wait until a key is pressed, unless the input source
+ * is unattended
+ *
+ * @param: input_p InputSource pointer
+ * @param: key character to wait for
+ *
+ * @return: 1 if the key was pressed, its arrival is in
+ * 		key_arrival_us, 0 if the source is unattended
+ */
+
+int key_wait(InputSource *input_p, char key)
+{
+	char ch;
+
+	if(input_p -> unattended())
+		return 0;
+
+	while(1)
+	{
+		if(input_p -> get_key(&ch))
+		{
+			if(ch == key)
+				return 1;
+		}
+		else
+			idle_wait(1);
+	}
+}
 
 /**
  * Debug method to view the stored platforms in platform_location
@@ -55,6 +998,60 @@ void print_locations()
 	uart.disp("\n\r\n\r");
 }
 
+#ifdef _DEBUG
+/**
+ * Debug method to print the MMIO write counts and wall time
+ * of each performance phase over UART, flagging any phase
+ * that went over its write or time budget
+ *
+ * @return: 1 if all phases were within budget, 0 otherwise
+ *
+ * @note: Counters are cleared after printing, so each report
+ * 		covers one game
+ * @note: The counts are the writes software issues, not the
+ * 		clocks they cost the video pipeline, see sim/cosim
+ */
+
+int perf_report()
+{
+	int pass = perf_check();
+
+	uart.disp("STATE HASH: ");
+	uart.disp((int) state_hash(), 16);
+	uart.disp("\n\r");
+
+	for(int i = 0; i < NUM_PHASES; i++)
+	{
+		uart.disp(perf[i].name);
+		uart.disp(" units: ");
+		uart.disp(perf[i].units);
+		uart.disp(" writes: ");
+		uart.disp((int) perf[i].writes);
+		uart.disp(" us: ");
+		uart.disp((int) perf[i].us);
+		uart.disp("\n\r");
+
+		perf[i].units = 0;
+		perf[i].writes = 0;
+		perf[i].us = 0;
+	}
+
+	for(int i = 0; i < NUM_LATENCY; i++)
+	{
+		uart.disp(i == LATENCY_STEER ? "STEER" : "KEY");
+		uart.disp(" latency us p50: ");
+		uart.disp((int) latency_percentile(i, 50));
+		uart.disp(" p90: ");
+		uart.disp((int) latency_percentile(i, 90));
+		uart.disp(" p99: ");
+		uart.disp((int) latency_percentile(i, 99));
+		uart.disp("\n\r");
+	}
+
+	return pass;
+}
+#endif
+
 /**
  * Generate the background of the game
  *
@@ -72,25 +1069,35 @@ void grid_draw( FrameCore *frame_p ) {
 	square_width = hmax / NUM_VERT_LINES;
 	square_height = vmax / NUM_HORIZ_LINES;
 
+	PERF_BEGIN(PHASE_GRID);
+
 	// Make sure frame is shown
 	frame_p->bypass(0);
 
 	// Beige color
+	// @note: clr_screen writes the frame pixel by pixel
 	frame_p->clr_screen(0x1FE);
+	PERF_COUNT(hmax * vmax);
+	PERF_HASH(hmax, vmax, 0x1FE);
 
 	// Vertical Grid Lines (Gray)
+	// @note: Keys are queued between lines
 	for( int i = 0; i < hmax; i = i + square_width )
 	{
 		for( int j = 0; j < vmax; j++ )
-		   frame_p -> wr_pix(i, j, 0x1B5);
+		   pix_write(frame_p, i, j, 0x1B5);
+		input_poll();
 	}
 
 	// Horizontal Grid lines (Darker Beige)
 	for( int i = 0; i < vmax; i = i + square_height )
 	{
 	   for( int j = 0; j < hmax; j++ )
-		   frame_p -> wr_pix(j, i, 0x1B5);
+		   pix_write(frame_p, j, i, 0x1B5);
+	   input_poll();
 	}
+
+	PERF_END();
 }
 
 /**
@@ -115,12 +1122,16 @@ void square_draw(FrameCore *frame_p, int x_square, int y_square)
 	int x_pixel_start = x_square * square_width;
 	int y_pixel_start = (NUM_HORIZ_LINES - y_square - 1) * square_height;
 
+	PERF_BEGIN(PHASE_DRAW);
+
 	// Draw a green box, starting from the bottom left of the square
 	for(int x = x_pixel_start; x < x_pixel_start + square_width; x++)
 	{
 		for(int y = y_pixel_start; y < y_pixel_start + square_height; y++)
-			frame_p -> wr_pix(x, y, 0x028);
+			pix_write(frame_p, x, y, 0x028);
 	}
+
+	PERF_END();
 }
 
 /**
@@ -145,10 +1156,12 @@ void square_restore(FrameCore *frame_p, int x_square, int y_square)
 	int x_pixel_start = x_square * square_width;
 	int y_pixel_start = (NUM_HORIZ_LINES - y_square - 1) * square_height;
 
+	PERF_BEGIN(PHASE_RESTORE);
+
 	// Restore the bottom of the square, which is the horizontal
 	// gray line
 	for(int x = x_pixel_start; x < x_pixel_start + square_width; x++)
-		frame_p -> wr_pix(x, y_pixel_start, 0x1B5);
+		pix_write(frame_p, x, y_pixel_start, 0x1B5);
 
 	// Restore the middle portion of the square
 	// @note: leftmost and rightmost pixels being the vertical gray grid lines
@@ -158,16 +1171,18 @@ void square_restore(FrameCore *frame_p, int x_square, int y_square)
 		for(int y = y_pixel_start + 1; y < y_pixel_start + square_height; y++)
 		{
 			if( (x == x_pixel_start) || (x == x_pixel_start + square_width) )
-				frame_p -> wr_pix(x, y, 0x1B5);
+				pix_write(frame_p, x, y, 0x1B5);
 			else
-				frame_p -> wr_pix(x, y, 0x1FE);
+				pix_write(frame_p, x, y, 0x1FE);
 		}
 	}
 
 	// Restore the top of the square, which is the horizontal
 	// gray line
 	for(int x = x_pixel_start; x < x_pixel_start + square_width; x++)
-		frame_p -> wr_pix(x, y_pixel_start + square_width, 0x1B5);
+		pix_write(frame_p, x, y_pixel_start + square_width, 0x1B5);
+
+	PERF_END();
 }
 
 /**
@@ -197,13 +1212,15 @@ void platform_intialize()
 	// Generate First Platform
 	// @note: Make sure platform will not be added
 	//		if in same location as player on start
-	y_rand = rand() % 100;
+	y_rand = platform_rand() % 100;
 	if( y_rand <= 90 )
-		x_rand = rand() % (NUM_VERT_LINES - 2);
-	if( !((x_rand == 9) | (x_rand == 10)) )
 	{
-		platform_location[1][x_rand] = 1;
-		platform_location[1][x_rand + 1] = 1;
+		x_rand = platform_rand() % (NUM_VERT_LINES - 2);
+		if( !((x_rand == 9) | (x_rand == 10)) )
+		{
+			platform_location[1][x_rand] = 1;
+			platform_location[1][x_rand + 1] = 1;
+		}
 	}
 
 	// Randomly Generate Rest of Platforms
@@ -211,10 +1228,10 @@ void platform_intialize()
 	// @note: Platform location on x is randomized
 	for(int y = 2; y < NUM_HORIZ_LINES * 2; y++)
 	{
-		y_rand = rand() % 100;
+		y_rand = platform_rand() % 100;
 		if( y_rand <= 80 )
 		{
-			x_rand = rand() % (NUM_VERT_LINES - 2);
+			x_rand = platform_rand() % (NUM_VERT_LINES - 2);
 			platform_location[y][x_rand] = 1;
 			platform_location[y][x_rand + 1] = 1;
 		}
@@ -259,10 +1276,10 @@ void platform_update(int shift)
 	// Generate platforms for the topmost (shift) arrays
 	for(int i = (NUM_HORIZ_LINES * 2) - shift; i < NUM_HORIZ_LINES * 2; i++)
 	{
-		y_rand = rand() % 100;
+		y_rand = platform_rand() % 100;
 		if( y_rand <= 90 )
 		{
-			x_rand = rand() % (NUM_VERT_LINES - 2);
+			x_rand = platform_rand() % (NUM_VERT_LINES - 2);
 			platform_location[i][x_rand] = 1;
 			platform_location[i][x_rand + 1] = 1;
 		}
@@ -283,6 +1300,7 @@ void platform_draw(FrameCore *frame_p)
 {
 	// Check if current coordinate in the array has
 	// a platform, draw a square there if so
+	// @note: Keys are queued between squares
 	for(int y = 0; y < NUM_HORIZ_LINES; y++)
 	{
 		for(int x = 0; x < NUM_VERT_LINES; x++)
@@ -290,6 +1308,35 @@ void platform_draw(FrameCore *frame_p)
 			if(platform_location[y][x] == 1)
 			{
 				square_draw(frame_p, x, y);
+				input_poll();
+			}
+		}
+	}
+}
+
+/**
+ * Erase the platforms on screen using the positions from the
+ * platform_location array and square_restore method, leaving
+ * only the background grid
+ *
+ * @param: frame_p FrameCore pointer
+ *
+ * @note: This is used for shifting the screen and for
+ * 		clearing the previous game's map on a restart
+ */
+
+void platform_erase(FrameCore *frame_p)
+{
+	// Check if a platform is at a current coordinate, restore if so
+	// @note: Keys are queued between squares
+	for(int y = 0; y < NUM_HORIZ_LINES; y++)
+	{
+		for(int x = 0; x < NUM_VERT_LINES; x++)
+		{
+			if(platform_location[y][x] == 1)
+			{
+				square_restore(frame_p, x, y);
+				input_poll();
 			}
 		}
 	}
@@ -349,21 +1396,63 @@ int collision_check(int x, int y)
 	return 0;
 }
 
+/**
+ * Play out the rest of a jump for the autopilot, holding one
+ * direction, the same way char_move moves the character
+ *
+ * @param: direction integer saying the steering held
+ * @param: rest integer saying the steps left rising
+ *
+ * @return: the row of the platform landed on, -1 if the
+ * 		character falls out of bounds
+ */
+
+int AutopilotInput::landing(int direction, int rest)
+{
+	int x = character_x;
+	int y = character_y;
+
+	while(1)
+	{
+		if(x + 2 * direction >= 0 && x + 2 * direction <= (NUM_VERT_LINES - 1) * square_width)
+			x += 2 * direction;
+
+		if(rest > 0)
+		{
+			y -= 2;
+			rest--;
+			continue;
+		}
+
+		if((y + 2) % square_height == 0)
+		{
+			int check = collision_check(x, y + 2);
+
+			if(check == 1)
+				return (NUM_HORIZ_LINES - 1) - ((y + 2) / square_height) - 2;
+			if(check == -1)
+				return -1;
+		}
+
+		y += 2;
+	}
+}
+
 /**
  * Death animation for the sprite, flash on and off
  * four times
  *
- * @param: sprite_p SpriteCore pointer
+ * @param: sprite_p DoodleCore pointer
  */
 
-void death_animation(SpriteCore *sprite_p)
+void death_animation(DoodleCore *sprite_p)
 {
 	for(int i = 0; i < 4; i++)
 	{
 		sprite_p -> bypass(1);
-		sleep_ms(100);
+		sprite_p -> frame_wait(6, input_poll);
 		sprite_p -> bypass(0);
-		sleep_ms(100);
+		sprite_p -> frame_wait(6, input_poll);
 	}
 }
 
@@ -380,32 +1469,24 @@ void gameover_draw(OsdCore *osd_p)
 	static char score_message[] = { 'F', 'I', 'N', 'A', 'L', ' ', 'S', 'C', 'O', 'R', 'E', ':' };
 	static char control_message[] = { '[', 'Y', ']', ' ', 'T', 'O', ' ', 'P', 'L', 'A', 'Y', ' ', 'A', 'G', 'A', 'I', 'N'};
 
-	// Calculate number of digits in the score
-	int number_digits;
-
-	if(score == 0)
-		number_digits = 1;
-	else
-		number_digits = floor( log10(abs(score))) + 1;
-
-	// Generate char array for the score;
-	char score_char[number_digits];
-	sprintf(score_char, "%d", score);
+	// Generate char array for the score, long enough for any int
+	char score_char[12];
+	int number_digits = sprintf(score_char, "%d", score);
 
 	// Display messages
 	osd_p -> clr_screen();
 
 	for (int i = 0; i < 9; i++)
-		osd_p->wr_char((40 - (9 / 2)) + i, 4, gameover_message[i], 0);
+		char_write(osd_p, (40 - (9 / 2)) + i, 4, gameover_message[i], 0);
 
 	for( int i = 0; i < 17; i++)
-		osd_p->wr_char((40 - (17 / 2)) + i, 5, control_message[i], 0);
+		char_write(osd_p, (40 - (17 / 2)) + i, 5, control_message[i], 0);
 
 	for (int i = 0; i < 12; i++)
-		osd_p->wr_char((40 - (12 / 2)) + i, 7, score_message[i], 0);
+		char_write(osd_p, (40 - (12 / 2)) + i, 7, score_message[i], 0);
 
 	for (int i = 0; i < number_digits; i++)
-		osd_p->wr_char((40 - (number_digits / 2)) + i, 8, score_char[i], 0);
+		char_write(osd_p, (40 - (number_digits / 2)) + i, 8, score_char[i], 0);
 
 	osd_p->bypass(0);
 }
@@ -421,25 +1502,22 @@ void score_draw(OsdCore *osd_p)
 {
 	const char score_message[] = {'S', 'C', 'O', 'R', 'E', ':'};
 
-	// Calculate number of digits in the score
-	int number_digits;
+	// Generate char array for the score, long enough for any int
+	char score_char[12];
+	int number_digits = sprintf(score_char, "%d", score);
 
-	if(score == 0)
-		number_digits = 1;
-	else
-		number_digits = floor( log10(abs(score))) + 1;
-
-	// Generate char array for the score;
-	char score_char[number_digits];
-	sprintf(score_char, "%d", score);
+	PERF_BEGIN(PHASE_SCORE);
+	PERF_UNITS(6 + number_digits);
 
 	for(int i = 0; i < 6; i++)
-			osd_p -> wr_char(1 + i, 1, score_message[i]);
+			char_write(osd_p, 1 + i, 1, score_message[i]);
 
 	for(int i = 0; i < number_digits; i++)
-			osd_p -> wr_char(7 + i, 1, score_char[i]);
+			char_write(osd_p, 7 + i, 1, score_char[i]);
 
 	osd_p -> bypass(0);
+	PERF_COUNT(1);
+	PERF_END();
 }
 
 /**
@@ -447,11 +1525,11 @@ void score_draw(OsdCore *osd_p)
  * freezing the system if it is paused and polling
  * until the unpause request is met
  *
- * @param: ps2_p Ps2Core pointer
+ * @param: input_p InputSource pointer
  * @param: osd_p OsdCore pointer
  */
 
-void pause_check(Ps2Core  *ps2_p, OsdCore *osd_p)
+void pause_check(InputSource *input_p, OsdCore *osd_p)
 {
 	// Char message arrays for OSD to display
 	const char pause_message[6] = {'P', 'A', 'U', 'S', 'E', 'D'};
@@ -459,30 +1537,37 @@ void pause_check(Ps2Core  *ps2_p, OsdCore *osd_p)
 
 	char pause_ch, unpause_ch;
 
-	if(ps2_p->get_kb_ch(&pause_ch))		// Check if a keyboard input was made
+	if(key_empty())						// Nothing was queued since the last step
+		return;
+
+	if(input_p -> get_key(&pause_ch))		// Check if a keyboard input was made
 	{
 		if(pause_ch == 'p')				// If inputted character was 'p', enter paused state
 		{
 			for(int i = 0; i < 6; i++)	// Display paused messages using OSD
-				osd_p -> wr_char((40 - (6 / 2)) + i, 4, pause_message[i]);
+				char_write(osd_p, (40 - (6 / 2)) + i, 4, pause_message[i]);
 
 			for(int i = 0; i < 14; i++)
-				osd_p -> wr_char((40 - (14 / 2)) + i, 5, subpause_message[i]);
+				char_write(osd_p, (40 - (14 / 2)) + i, 5, subpause_message[i]);
 
 			osd_p -> bypass(0);
+			latency_record(LATENCY_KEY, key_arrival_us);
 
 			// Keep in loop until unpause character 'u' was entered
 			while(1)
 			{
-				if(ps2_p -> get_kb_ch(&unpause_ch))	// Check if a keyboard input was made
+				if(input_p -> get_key(&unpause_ch))	// Check if a keyboard input was made
 				{
 					if(unpause_ch == 'u')	// If inputted character was 'u', exit paused state
 					{
 						osd_p -> clr_screen();	// Clear OSD and hide it
 						osd_p -> bypass(1);
+						latency_record(LATENCY_KEY, key_arrival_us);
 						return;					// Exit
 					}
 				}
+				else
+					idle_wait(1);
 			}
 		}
 	}
@@ -495,25 +1580,19 @@ void pause_check(Ps2Core  *ps2_p, OsdCore *osd_p)
  * involving updating the screen, checking for collision,
  * and calculating the score
  *
- * @param: ps2_p Ps2Core pointer
- * @param: sprite_p SpriteCore pointer
- * @param: adc_p XadcCore pointer
+ * @param: input_p InputSource pointer
+ * @param: sprite_p DoodleCore pointer
  * @param: frame_p FrameCore pointer
  * @param: osd_p OsdCore pointer
  */
 
-void char_move(Ps2Core *ps2_p, SpriteCore *sprite_p, XadcCore *adc_p, FrameCore *frame_p, OsdCore *osd_p) {
+void char_move(InputSource *input_p, DoodleCore *sprite_p, FrameCore *frame_p, OsdCore *osd_p) {
 	int hmax = frame_p -> HMAX;
 	int x_temp, y_temp;
 
-	// Constants for calculating the movement using the XADC
-	// read_reference is the median value in the XADC read range
-	// read_offset is the offset for determining if the character moves
-	const double read_reference = XADC_REFERENCE;
-	const double read_offset = XADC_OFFSET;
-
 	int isFalling = 0;
 	int highest_line = 2;
+	int facing = 0;		// SPRITE_MIRROR when facing left
 
 	// Main loop of the game, runs until the character moves out of bounds and the game is over
 	while(1)
@@ -524,33 +1603,25 @@ void char_move(Ps2Core *ps2_p, SpriteCore *sprite_p, XadcCore *adc_p, FrameCore
 		for(int i = 0; i < 64; i++)
 		{
 			// Check for pause
-			pause_check(ps2_p, osd_p);
+			pause_check(input_p, osd_p);
+			PERF_BEGIN(PHASE_STEP);
 			// Redraw score in case it was removed from the pause
 			score_draw(osd_p);
 
-			// Read from XADC, see which direction character is moving
-			double read_temp = adc_p -> read_adc_in(0);
-			double read_diff = read_reference - read_temp;
-			int direction;
-			if(abs(read_diff) > read_offset)	// If the difference between reference and read_temp
-			{									// is greater than threshold, a direction is specified
-				if(read_diff < 0)
-					direction = 1;		// If the difference is positive, moving rightwards
-				else if(read_diff > 0)		// If the difference is negative, moving leftwards
-					direction = -1;
-			}
-			else 							// Else, no direction is specified
-			{
-				direction = 0;
-			}
+			// Read from the input source, see which direction character is moving
+			// @note: sample_us times the sample until the move is shown
+			unsigned long sample_us = now_us();
+			int direction = input_p -> direction();
+
+			// Clamp to -1, 0 or 1, in case a source returns a larger value
+			direction = (direction > 0) - (direction < 0);
+
+			// Face the direction of travel, keep the last facing when not steering
+			if(direction != 0)
+				facing = (direction == -1) ? SPRITE_MIRROR : 0;
 
 			// Use direction to determine the next x_value
-			if(direction == -1)
-				x_temp = character_x - 2;
-			else if(direction == 0)
-				x_temp = character_x;
-			else if(direction == 1)
-				x_temp = character_x + 2;
+			x_temp = character_x + 2 * direction;
 
 			// Check if next x_value is within the screen, if so, update
 			// global character_x value
@@ -565,10 +1636,15 @@ void char_move(Ps2Core *ps2_p, SpriteCore *sprite_p, XadcCore *adc_p, FrameCore
 			//		Subtracting means it is going up (jumping)
 			character_y -= 2;
 
-			// Update the characters position
-			sprite_p -> move_xy(character_x, character_y);
+			// Update the characters position, showing the landing frame
+			// at the start of the jump
+			sprite_move(sprite_p, character_x, character_y,
+					facing | ((i < LAND_STEPS) ? SPRITE_LAND : SPRITE_JUMP));
+			steer_written(sprite_p, sample_us);
+			PERF_END();
 			// Delay between steps, this dictates how smoothly the character moves
-			sleep_ms(10);
+			// @note: Keys are queued during the delay
+			idle_wait(10);
 		}
 
 		// Falling logic, runs indefinitely until either hitting a platform or
@@ -579,36 +1655,28 @@ void char_move(Ps2Core *ps2_p, SpriteCore *sprite_p, XadcCore *adc_p, FrameCore
 		isFalling = 1;	// Reset isFalling flag to 1
 		do {
 			// Check for pause
-			pause_check(ps2_p, osd_p);
+			pause_check(input_p, osd_p);
+			PERF_BEGIN(PHASE_STEP);
 			// Redraw score in case it was removed from the pause
 			score_draw(osd_p);
 
 			// Reset the lineReference at beginning of each step
 			int Y_Reference_temp = Y_REFERENCE;
 
-			// Read from XADC, see which direction character is moving
-			double read_temp = adc_p -> read_adc_in(0);
-			double read_diff = read_reference - read_temp;
-			int direction;
-			if(abs(read_diff) > read_offset)	// If the difference between reference and read_temp
-			{									// is greater than threshold, a direction is specified
-				if(read_diff < 0)
-					direction = 1;		// If the difference is positive, moving rightwards
-				else if(read_diff > 0)		// If the difference is negative, moving leftwards
-					direction = -1;
-			}
-			else 							// Else, no direction is specified
-			{
-				direction = 0;
-			}
+			// Read from the input source, see which direction character is moving
+			// @note: sample_us times the sample until the move is shown
+			unsigned long sample_us = now_us();
+			int direction = input_p -> direction();
+
+			// Clamp to -1, 0 or 1, in case a source returns a larger value
+			direction = (direction > 0) - (direction < 0);
+
+			// Face the direction of travel, keep the last facing when not steering
+			if(direction != 0)
+				facing = (direction == -1) ? SPRITE_MIRROR : 0;
 
 			// Use direction to determine the next x_value
-			if(direction == -1)
-				x_temp = character_x - 2;
-			else if(direction == 0)
-				x_temp = character_x;
-			else if(direction == 1)
-				x_temp = character_x + 2;
+			x_temp = character_x + 2 * direction;
 
 			// Check if next x_value is within the screen, if so, update
 			// global character_x value
@@ -654,6 +1722,7 @@ void char_move(Ps2Core *ps2_p, SpriteCore *sprite_p, XadcCore *adc_p, FrameCore
 				}
 				else if( check == -1 )	// If it causes the character to go out of bounds ( game over)
 				{
+					PERF_END();
 					// Play death animation
 					death_animation(sprite_p);
 					// Exit this method, ending the game logic
@@ -680,17 +1749,8 @@ void char_move(Ps2Core *ps2_p, SpriteCore *sprite_p, XadcCore *adc_p, FrameCore
 			{
 				diff = Y_Reference_temp - Y_REFERENCE;
 
-				// Check if a platform is at a current coordinate, restore if so
-				for(int i = 0; i < NUM_HORIZ_LINES; i++)
-				{
-					for(int j = 0; j < NUM_VERT_LINES; j++)
-					{
-						if(platform_location[i][j] == 1)
-						{
-							square_restore(frame_p, j, i);
-						}
-					}
-				}
+				// Restore the squares of the current platforms
+				platform_erase(frame_p);
 
 				// Update the highest line with the array shift
 				highest_line -= diff;
@@ -703,10 +1763,13 @@ void char_move(Ps2Core *ps2_p, SpriteCore *sprite_p, XadcCore *adc_p, FrameCore
 			}
 
 			// Update the character position
-			sprite_p -> move_xy(character_x, character_y);
+			sprite_move(sprite_p, character_x, character_y, facing | SPRITE_FALL);
+			steer_written(sprite_p, sample_us);
 
+			PERF_END();
 			// Delay between steps, this dictates how smoothly the character moves
-			sleep_ms(10);
+			// @note: Keys are queued during the delay
+			idle_wait(10);
 
 		} while( isFalling );
 	}
@@ -717,49 +1780,52 @@ void char_move(Ps2Core *ps2_p, SpriteCore *sprite_p, XadcCore *adc_p, FrameCore
  * the game logic, displaying OSDs, and handling game over
  *
  * @param: ps2_p Ps2Core pointer
- * @param: sprite_p SpriteCore pointer
- * @param: adc_p XadcCore pointer
+ * @param: input_p InputSource pointer
+ * @param: sprite_p DoodleCore pointer
  * @param: frame_p FrameCore pointer
  * @param: osd_p OsdCore pointer
  * @param: osd2_p OsdCore pointer ( for score only )
  */
 
-void game_run(Ps2Core *ps2_p, SpriteCore *sprite_p, XadcCore *adc_p, FrameCore *frame_p, OsdCore *osd_p)
+void game_run(Ps2Core *ps2_p, InputSource *input_p, DoodleCore *sprite_p, FrameCore *frame_p, OsdCore *osd_p)
 {
 	// Reset OSDs
 	osd_p->set_color(0x0f0, 0x001); // dark gray/green
 	osd_p->clr_screen();
 
-	// Display Background Grid Lines
-	grid_draw(frame_p);
-
-	// Generate Map in Memory
-	platform_intialize();
-	print_locations();
-
-	// Display First Platforms
-	platform_draw(frame_p);
+	// Instantiate Keyboard on the first game, if not found, quit.
+	// @note: Unattended input sources can play without one
+	// @note: Restarts only clear the key queue, so they cost no
+	//		more than restoring and drawing the platforms
+	if( !keyboard_checked )
+	{
+		int id;
 
-	// Instantiate Keyboard, if not found, quit.
-	int id;
+		uart.disp("\n\rPlease Connect Keyboard ");
+		id = ps2_p->init();
+		uart.disp(id);
+		if( id == 1 )
+		{
+			uart.disp("...Connected!\n\r");
+			key_queue_init(ps2_p);
+		}
+		else if( input_p -> unattended() )
+		{
+			uart.disp("...Not Connected, Playing Unattended!\n\r");
+			key_queue_init(0);
+		}
+		else
+		{
+		   uart.disp("...Not Connected, Quitting!\n\r");
+		   return;
+		}
 
-	uart.disp("\n\rPlease Connect Keyboard ");
-	id = ps2_p->init();
-	uart.disp(id);
-	if( id == 1 )
-		uart.disp("...Connected!\n\r");
-	else
-	{
-	   uart.disp("...Not Connected, Quitting!\n\r");
-	   return;
+		keyboard_checked = 1;
 	}
+	else
+		key_queue_init(key_ps2_p);
 
-	// Display Sprite Once Ready
-	character_x = 320;
-	character_y = (frame_p -> VMAX) - (3* square_height);
-
-	sprite_p -> move_xy(character_x, character_y);
-	sprite_p -> bypass(0);
+	input_p -> reset();
 
 	// Display Game Start title screen on OSD
 	const char title_message[] = {'E', 'C', 'E', ' ', '4', '3', '0', '5'};
@@ -770,58 +1836,75 @@ void game_run(Ps2Core *ps2_p, SpriteCore *sprite_p, XadcCore *adc_p, FrameCore *
 							' ','U', 'N', 'P', 'A', 'U', 'S', 'E', ':', ' ', '[', 'U', ']'};
 
 	for(int i = 0; i < 8; i++)
-		osd_p -> wr_char((40 - (8 / 2)) + i, 4, title_message[i]);
+		char_write(osd_p, (40 - (8 / 2)) + i, 4, title_message[i]);
 
 	for(int i = 0; i < 11; i++)
-		osd_p -> wr_char((40 - (11 / 2)) + i, 5, subtitle_message[i]);
+		char_write(osd_p, (40 - (11 / 2)) + i, 5, subtitle_message[i]);
 
 	for (int i = 0; i < 19; i++)
-		osd_p->wr_char((40 - (19 / 2)) + i, 7, ready_message[i]);
+		char_write(osd_p, (40 - (19 / 2)) + i, 7, ready_message[i]);
 
 	for( int i = 0; i < 23; i++)
-	   osd_p->wr_char((40 - (23 / 2)) + i, 8, controls_message[i]);
+	   char_write(osd_p, (40 - (23 / 2)) + i, 8, controls_message[i]);
 
    osd_p->bypass(0);
 
-   // Wait for user to input 'r' to start game
-   char ready;
-
-   while(1)
+   // Display Background Grid Lines, drawn while the title is up
+   // @note: On a restart the grid is still on screen and only the
+   //		previous game's platforms differ from it, so only those
+   //		squares are restored instead of repainting the whole frame
+   if(background_drawn)
+	   platform_erase(frame_p);
+   else
    {
-	   if(ps2_p->get_kb_ch(&ready))
-	   {
-		   if(ready == 'r')
-			   break;
-	   }
-	}
+	   grid_draw(frame_p);
+	   background_drawn = 1;
+   }
+
+   // Generate Map in Memory
+   platform_intialize();
+#ifdef _DEBUG
+   print_locations();
+#endif
+
+   // Display First Platforms
+   platform_draw(frame_p);
+
+   // Display Sprite Once Ready
+   character_x = 320;
+   character_y = (frame_p -> VMAX) - (3* square_height);
+
+   sprite_move(sprite_p, character_x, character_y, SPRITE_AUTO);
+   sprite_p -> bypass(0);
+
+   // Wait for user to input 'r' to start game
+   int pressed = key_wait(input_p, 'r');
 
    // Remove Game Start title after user is ready
    osd_p -> clr_screen();
    osd_p -> bypass(1);
+   if(pressed)
+	   latency_record(LATENCY_KEY, key_arrival_us);
 
    // Start Game, Exit if Player Loses or Game Ends
    score = 0;
    score_draw(osd_p);
-   char_move(ps2_p, sprite_p, adc_p, frame_p, osd_p);
+   char_move(input_p, sprite_p, frame_p, osd_p);
 
    // Game Ended, Display Death Animation and "GAME OVER" message on OSD
    death_animation(sprite_p);
    gameover_draw(osd_p);
 
-   char input;
+#ifdef _DEBUG
+   if(!perf_report())
+	   regression_fail("BUDGET");
+#endif
 
    // Wait for user to input 'y' to re-start the game
-   while(1)
-   {
-	   if(ps2_p->get_kb_ch(&input))
-	   {
-		   if(input == 'y')
-		   {
-			   osd_p -> bypass(1);
-			   break;
-		   }
-	   }
-	}
+   pressed = key_wait(input_p, 'y');
+   osd_p -> bypass(1);
+   if(pressed)
+	   latency_record(LATENCY_KEY, key_arrival_us);
 
    sprite_p -> bypass(1);
 }
@@ -829,11 +1912,44 @@ void game_run(Ps2Core *ps2_p, SpriteCore *sprite_p, XadcCore *adc_p, FrameCore *
 Ps2Core ps2(get_slot_addr(BRIDGE_BASE, S11_PS2));
 SpriteCore mouse(get_sprite_addr(BRIDGE_BASE, V1_MOUSE), 1024);
 SpriteCore ghost(get_sprite_addr(BRIDGE_BASE, V3_GHOST), 1024);
-SpriteCore doodle(get_sprite_addr(BRIDGE_BASE, V5_USER5), 1024);
+DoodleCore doodle(get_sprite_addr(BRIDGE_BASE, V5_USER5), 8192);
 FrameCore frame(FRAME_BASE);
 XadcCore adc(get_slot_addr(BRIDGE_BASE, S5_XDAC));
 OsdCore osd(get_sprite_addr(BRIDGE_BASE, V2_OSD));
 
+// Steering script for replay_input, steps are counted from the start of the game
+// @note: The first 800 steps autopilot_input plays, then it holds right until it
+//		falls out of bounds at step 1050 with a score of 2600, so a replay covers
+//		scrolling, game over and the restart
+const replay_event_t replay_script[] = {
+	{1, 1}, {81, 0}, {97, 1}, {113, 0}, {178, -1}, {195, 0}, {242, -1}, {243, 0},
+	{293, -1}, {387, 0}, {388, -1}, {453, 0}, {485, -1}, {533, 0}, {581, 1}, {662, 0},
+	{663, 1}, {727, 0}, {792, -1}, {793, 1}
+};
+
+// Known good state_hash() of replay_script, checked by debug builds at steps
+// counted over every game: through the first jump, the climb, the last step
+// before the first game over, the restarted game and the third game
+// @note: Recorded with the host build in sim/ (make golden), record them again
+//		after a change to the set of writes, even one that draws the same screen
+const replay_check_t replay_checks_game[] = {
+	{64, 0x553c3a21u},
+	{600, 0x7de3bac9u},
+	{1049, 0x262b2854u},
+	{1100, 0xa44696f9u},
+	{2200, 0x4b3bd5c2u}
+};
+
+XadcInput xadc_input(&adc);
+KeyboardInput keyboard_input;
+ReplayInput replay_input(replay_script, sizeof(replay_script) / sizeof(replay_script[0]),
+		replay_checks_game, sizeof(replay_checks_game) / sizeof(replay_checks_game[0]));
+AutopilotInput autopilot_input;
+
+// Input source the game is played with, swap for keyboard_input,
+// replay_input or autopilot_input
+InputSource *input_source = &xadc_input;
+
 int main() {
 	ghost.bypass(1);
 	mouse.bypass(1);
@@ -843,7 +1959,7 @@ int main() {
 
 	while(1)
 	{
-		game_run(&ps2, &doodle, &adc, &frame, &osd);
+		game_run(&ps2, input_source, &doodle, &frame, &osd);
 	}
 }
 
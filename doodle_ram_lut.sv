@@ -1,7 +1,8 @@
 module doodle_ram_lut 
    #(
     parameter ADDR_WIDTH = 10,  // number of address bits
-              DATA_WIDTH = 2    // color depth
+              DATA_WIDTH = 2,   // color depth
+              INIT_FILE = "doodle_bitmap.txt"   // initial ram values, "" for none
    )
    (
     input  logic clk,
@@ -16,9 +17,10 @@ module doodle_ram_lut
    logic [DATA_WIDTH-1:0] ram [0:2**ADDR_WIDTH-1];
    logic [DATA_WIDTH-1:0] data_reg;
    
-   // doodle_bitmap.txt specifies the initial values of ram 
+   // INIT_FILE (doodle_bitmap.txt) specifies the initial values of ram 
    initial 
-      $readmemb("E:/GoogleDrive/Sync/ECE_4305/Complete_SoC/Complete_SoC/Complete_SoC.srcs/sources_1/imports/Downloads/doodle_bitmap.txt", ram);
+      if (INIT_FILE != "")
+         $readmemb(INIT_FILE, ram);
       
    // body
    always_ff @(posedge clk)
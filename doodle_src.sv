@@ -2,13 +2,14 @@ module doodle_src
    #(
     parameter CD = 12,      // color depth
               ADDR = 10,    // number of address bits
-              KEY_COLOR =0  // chroma key
+              KEY_COLOR =0, // chroma key
+              INIT_FILE = "doodle_bitmap.txt"   // sprite bitmap
    )
    (
     input  logic clk,
     input  logic [10:0] x, y,   // x-and  y-coordinate    
     input  logic [10:0] x0, y0, // origin of sprite 
-    input  logic [4:0] ctrl,    // sprite control 
+    input  logic [5:0] ctrl,    // sprite control 
     // sprite ram write 
     input  logic we ,
     input  logic [ADDR-1:0] addr_w,
@@ -24,7 +25,8 @@ module doodle_src
    logic signed [11:0] xr, yr;  // relative x/y position
    logic in_region;
    logic [ADDR-1:0] addr_r;
-   logic  sid;             // sprite id   
+   logic [4:0] xm;              // relative x, mirrored if requested
+   logic [1:0] sid;             // sprite id   
    logic [1:0] plt_code;        
    logic frame_tick, ani_tick;
    logic [3:0] c_next;        
@@ -38,20 +40,23 @@ module doodle_src
    logic [1:0] gc_color_sel;        
    logic [1:0] gc_id_sel;        
    logic auto;        
+   logic mirror;        
    
    // body 
    assign gc_color_sel = ctrl[4:3];
    assign gc_id_sel = ctrl[1:0];
    assign auto = ctrl[2];
+   assign mirror = ctrl[5];     // face left, read each row right to left
 
    //******************************************************************
    // sprite RAM
    //******************************************************************
    // instantiate sprite RAM
-   doodle_ram_lut #(.ADDR_WIDTH(ADDR), .DATA_WIDTH(2)) ram_unit (
+   doodle_ram_lut #(.ADDR_WIDTH(ADDR), .DATA_WIDTH(2), .INIT_FILE(INIT_FILE)) ram_unit (
       .clk(clk), .we(we), .addr_w(addr_w), .din(pixel_in),
       .addr_r(addr_r), .dout(plt_code));
-   assign addr_r = {sid, yr[5:0], xr[4:0]}; // Increased yr to 6 bits to accomodate for 64 bit sprite height
+   assign xm = (mirror) ? ~xr[4:0] : xr[4:0];  // ~xr is 31 - xr within the 32 pixel row
+   assign addr_r = {sid, yr[5:0], xm}; // Increased yr to 6 bits to accomodate for 64 bit sprite height
  
    //******************************************************************
    // ghost color control
@@ -0,0 +1,171 @@
+// Testbench for the doodle sprite core registers
+//
+//   * x0/y0/ctrl written mid-frame stay in the shadow registers
+//     and reach the live registers only on the rising edge of
+//     frame_start, not while it is held high
+//   * one write to 0x2004 commits x, y and ctrl together
+//   * the frame counter at 0x2000 counts once per frame and
+//     reads 0 when the core or the register is not selected
+//
+// Run from sim/ with "make tb"
+
+`timescale 1ns/1ps
+
+module chu_vga_sprite_doodle_core_tb;
+
+   localparam REG_BYPASS = 14'h2000;
+   localparam REG_X0     = 14'h2001;
+   localparam REG_Y0     = 14'h2002;
+   localparam REG_CTRL   = 14'h2003;
+   localparam REG_XYC    = 14'h2004;
+
+   logic clk, reset;
+   logic [10:0] x, y;
+   logic frame_start;
+   logic cs, write;
+   logic [13:0] addr;
+   logic [31:0] wr_data, rd_data;
+   logic [11:0] si_rgb, so_rgb;
+   integer errors;
+
+   chu_vga_sprite_doodle_core #(.INIT_FILE("../doodle_bitmap.txt")) dut (
+      .clk(clk), .reset(reset), .x(x), .y(y), .frame_start(frame_start),
+      .cs(cs), .write(write), .addr(addr), .wr_data(wr_data), .rd_data(rd_data),
+      .si_rgb(si_rgb), .so_rgb(so_rgb));
+
+   // 100 MHz system clock
+   always #5 clk = ~clk;
+
+   // inputs change on the falling edge, the core samples on the rising edge
+   task bus_write(input [13:0] a, input [31:0] d);
+      begin
+         @(negedge clk);
+         cs = 1;
+         write = 1;
+         addr = a;
+         wr_data = d;
+         @(negedge clk);
+         cs = 0;
+         write = 0;
+      end
+   endtask
+
+   // read with the address held, rd_data is combinational
+   task bus_read(input logic sel, input [13:0] a, output [31:0] d);
+      begin
+         @(negedge clk);
+         cs = sel;
+         write = 0;
+         addr = a;
+         #1 d = rd_data;
+         cs = 0;
+      end
+   endtask
+
+   // frame_start comes from the pixel counter, so it is held for
+   // the 4 clocks of the first pixel
+   task frame_pulse;
+      begin
+         @(negedge clk);
+         frame_start = 1;
+         repeat (4) @(negedge clk);
+         frame_start = 0;
+      end
+   endtask
+
+   task check(input [8*32-1:0] what, input [31:0] got, input [31:0] want);
+      if (got !== want) begin
+         $display("FAIL %0s: got %0d want %0d", what, got, want);
+         errors = errors + 1;
+      end
+   endtask
+
+   task check_live(input [8*32-1:0] what, input [10:0] lx, input [10:0] ly, input [5:0] lctrl);
+      if (dut.x0_reg !== lx || dut.y0_reg !== ly || dut.ctrl_reg !== lctrl) begin
+         $display("FAIL %0s: live x0 %0d y0 %0d ctrl %h, want %0d %0d %h",
+                  what, dut.x0_reg, dut.y0_reg, dut.ctrl_reg, lx, ly, lctrl);
+         errors = errors + 1;
+      end
+   endtask
+
+   logic [31:0] count, count_next, d;
+
+   initial begin
+      clk = 0;
+      reset = 1;
+      x = 0;
+      y = 0;
+      frame_start = 0;
+      cs = 0;
+      write = 0;
+      addr = 0;
+      wr_data = 0;
+      si_rgb = 12'h0a5;
+      errors = 0;
+      repeat (2) @(negedge clk);
+      reset = 0;
+      check_live("reset", 0, 0, 6'b000100);
+
+      // separate writes mid-frame
+      bus_write(REG_X0, 100);
+      bus_write(REG_Y0, 200);
+      bus_write(REG_CTRL, 6'h25);
+      repeat (10) @(negedge clk);
+      check_live("mid-frame writes", 0, 0, 6'b000100);
+
+      // commit on the clock that sees the rising edge
+      @(negedge clk);
+      frame_start = 1;
+      #1 check_live("before the edge", 0, 0, 6'b000100);
+      @(posedge clk);
+      #1 check_live("at the edge", 100, 200, 6'h25);
+
+      // a write while frame_start is still high waits for the next frame
+      bus_write(REG_X0, 300);
+      repeat (2) @(negedge clk);
+      frame_start = 0;
+      repeat (4) @(negedge clk);
+      check_live("frame_start held high", 100, 200, 6'h25);
+      frame_pulse();
+      check_live("next frame", 300, 200, 6'h25);
+
+      // one 0x2004 write commits x, y and ctrl together
+      bus_write(REG_XYC, 32'd400 | (32'd150 << 11) | (32'h1a << 22));
+      repeat (10) @(negedge clk);
+      check_live("xyc mid-frame", 300, 200, 6'h25);
+      @(negedge clk);
+      frame_start = 1;
+      @(posedge clk);
+      #1 check_live("xyc at the edge", 400, 150, 6'h1a);
+      @(negedge clk);
+      frame_start = 0;
+
+      // frame counter counts once per frame, however long frame_start is high
+      bus_read(1, REG_BYPASS, count);
+      check("frame count after 3 frames", count, 3);
+      repeat (5) begin
+         frame_pulse();
+         repeat (20) @(negedge clk);
+         bus_read(1, REG_BYPASS, count_next);
+         check("frame count step", count_next, count + 1);
+         count = count_next;
+      end
+
+      // only the selected register at 0x2000 drives rd_data
+      bus_read(0, REG_BYPASS, d);
+      check("read without cs", d, 0);
+      bus_read(1, REG_X0, d);
+      check("read 0x2001", d, 0);
+      bus_read(1, REG_XYC, d);
+      check("read 0x2004", d, 0);
+      bus_read(1, 14'h0000, d);
+      check("read sprite ram", d, 0);
+
+      if (errors == 0)
+         $display("chu_vga_sprite_doodle_core_tb PASS");
+      else
+         $fatal(1, "chu_vga_sprite_doodle_core_tb FAIL %0d errors", errors);
+      $finish;
+   end
+
+endmodule
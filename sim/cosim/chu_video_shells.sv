@@ -0,0 +1,160 @@
+// Port-only shells of the FPro video cores video_sys_daisy
+// instantiates, which are not in this tree. They let "make lint"
+// elaborate video_sys_daisy and check its doodle core hookup and
+// read mux; they are never simulated. Video cores pass si_rgb
+// through, the controller decodes the address map at the top of
+// video_sys_daisy.sv
+
+module frame_counter
+   #(parameter HMAX = 640, VMAX = 480)
+   (
+    input  logic clk, reset,
+    input  logic inc, sync_clr,
+    output logic [10:0] hcount, vcount,
+    output logic frame_start, frame_end
+   );
+   assign hcount = 11'd0;
+   assign vcount = 11'd0;
+   assign frame_start = 1'b0;
+   assign frame_end = 1'b0;
+endmodule
+
+module chu_video_controller
+   (
+    input  logic video_cs,
+    input  logic video_wr,
+    input  logic [20:0] video_addr,
+    input  logic [31:0] video_wr_data,
+    output logic frame_cs,
+    output logic frame_wr,
+    output logic [19:0] frame_addr,
+    output logic [31:0] frame_wr_data,
+    output logic [7:0] slot_cs_array,
+    output logic [7:0] slot_mem_wr_array,
+    output logic [13:0] slot_reg_addr_array [7:0],
+    output logic [31:0] slot_wr_data_array [7:0]
+   );
+   assign frame_cs = video_cs && video_addr[20];
+   assign frame_wr = video_wr;
+   assign frame_addr = video_addr[19:0];
+   assign frame_wr_data = video_wr_data;
+   always_comb
+      for (int i = 0; i < 8; i++) begin
+         slot_cs_array[i] = video_cs && ~video_addr[20] && (video_addr[16:14] == i[2:0]);
+         slot_mem_wr_array[i] = video_wr;
+         slot_reg_addr_array[i] = video_addr[13:0];
+         slot_wr_data_array[i] = video_wr_data;
+      end
+endmodule
+
+module chu_frame_buffer_core
+   #(parameter CD = 12, DW = 9)
+   (
+    input  logic clk, reset,
+    input  logic [10:0] x, y,
+    input  logic cs, write,
+    input  logic [19:0] addr,
+    input  logic [31:0] wr_data,
+    input  logic [CD-1:0] si_rgb,
+    output logic [CD-1:0] so_rgb
+   );
+   assign so_rgb = si_rgb;
+endmodule
+
+module chu_vga_bar_core
+   (
+    input  logic clk, reset,
+    input  logic [10:0] x, y,
+    input  logic cs, write,
+    input  logic [13:0] addr,
+    input  logic [31:0] wr_data,
+    input  logic [11:0] si_rgb,
+    output logic [11:0] so_rgb
+   );
+   assign so_rgb = si_rgb;
+endmodule
+
+module chu_rgb2gray_core
+   (
+    input  logic clk, reset,
+    input  logic cs, write,
+    input  logic [13:0] addr,
+    input  logic [31:0] wr_data,
+    input  logic [11:0] si_rgb,
+    output logic [11:0] so_rgb
+   );
+   assign so_rgb = si_rgb;
+endmodule
+
+module chu_vga_dummy_core
+   (
+    input  logic clk, reset,
+    input  logic cs, write,
+    input  logic [13:0] addr,
+    input  logic [31:0] wr_data,
+    input  logic [11:0] si_rgb,
+    output logic [11:0] so_rgb
+   );
+   assign so_rgb = si_rgb;
+endmodule
+
+module chu_vga_sprite_ghost_core
+   #(parameter CD = 12, ADDR_WIDTH = 10, KEY_COLOR = 0)
+   (
+    input  logic clk, reset,
+    input  logic [10:0] x, y,
+    input  logic cs, write,
+    input  logic [13:0] addr,
+    input  logic [31:0] wr_data,
+    input  logic [CD-1:0] si_rgb,
+    output logic [CD-1:0] so_rgb
+   );
+   assign so_rgb = si_rgb;
+endmodule
+
+module chu_vga_osd_core
+   #(parameter CD = 12, KEY_COLOR = 0)
+   (
+    input  logic clk, reset,
+    input  logic [10:0] x, y,
+    input  logic cs, write,
+    input  logic [13:0] addr,
+    input  logic [31:0] wr_data,
+    input  logic [CD-1:0] si_rgb,
+    output logic [CD-1:0] so_rgb
+   );
+   assign so_rgb = si_rgb;
+endmodule
+
+module chu_vga_sprite_mouse_core
+   #(parameter CD = 12, ADDR_WIDTH = 10, KEY_COLOR = 0)
+   (
+    input  logic clk, reset,
+    input  logic [10:0] x, y,
+    input  logic cs, write,
+    input  logic [13:0] addr,
+    input  logic [31:0] wr_data,
+    input  logic [CD-1:0] si_rgb,
+    output logic [CD-1:0] so_rgb
+   );
+   assign so_rgb = si_rgb;
+endmodule
+
+module chu_vga_sync_core
+   #(parameter CD = 12)
+   (
+    input  logic clk_sys, clk_25M, reset,
+    input  logic cs, write,
+    input  logic [13:0] addr,
+    input  logic [31:0] wr_data,
+    input  logic [CD:0] si_data,
+    input  logic si_valid,
+    output logic si_ready,
+    output logic hsync, vsync,
+    output logic [CD-1:0] rgb
+   );
+   assign si_ready = 1'b1;
+   assign hsync = 1'b0;
+   assign vsync = 1'b0;
+   assign rgb = si_data[CD:1];
+endmodule
@@ -0,0 +1,311 @@
+/*
+ * cosim.cpp
+ *
+ *  Co-simulation of doodle_game.cpp with the doodle sprite core RTL.
+ *  The game runs on the FPro model in host_model.cpp, and this
+ *  bus-functional model carries every access to the doodle core's
+ *  slot, 0x2000 to 0x2004 and the sprite memory, to the Verilated
+ *  cosim_top. The RTL runs at 100 clocks per microsecond of simulated
+ *  time, which host_model.cpp advances by HOST_ACCESS_NS per bus
+ *  access. A storm of frame buffer writes therefore takes its bus time
+ *  while the core scans frames, and the sprite move after it waits
+ *  for it, as on the board. The frame counter the game reads comes
+ *  from the core, so frame_wait() follows the real scan
+ *
+ *  Usage: cosim [-a] [-s steps] [-d frames] [-v]
+ *  	-a	play autopilot_input instead of replay_input
+ *  	-s	sprite moves to run, 300 by default
+ *  	-d	dump every that many frames as build/frames/frame_NNNNN.ppm,
+ *  		0 for none, 60 by default
+ *  	-v	show the game's UART output
+ *
+ *  Prints, for each performance phase, its bus accesses, the system
+ *  clocks and frames it ran for, and the clocks from each sprite move
+ *  written in it until the core commits the move
+ *
+ *  @note: Only the doodle slot is modeled in RTL, with cs held for
+ *  		one clock of each access's time. The cost of an access is
+ *  		HOST_ACCESS_NS, the WRITE_NS estimate of a wr_pix() on the
+ *  		board, not a measurement. The frame buffer and OSD cores
+ *  		are not in this tree: their writes land in host_model.cpp,
+ *  		the frame buffer feeding si_rgb and the OSD left out of
+ *  		the dumps
+ */
+
+#include <setjmp.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "verilated.h"
+#include "Vcosim_top.h"
+#include "host_model.h"
+
+static void cosim_halt();
+
+#define REGRESSION_HALT() cosim_halt()
+#define main doodle_main
+#include "../../doodle_game.cpp"
+#undef main
+
+#define COSIM_CLOCKS_PER_US 100			// 100 MHz system clock
+#define COSIM_OTHER NUM_PHASES				// Counters for time outside every phase
+#define COSIM_MOVES 8						// Sprite moves held until committed
+#define COSIM_FRAME_DIR "build/frames"
+#define COSIM_DOODLE_BASE get_sprite_addr(BRIDGE_BASE, V5_USER5)
+#define COSIM_VIDEO_BASE get_sprite_addr(BRIDGE_BASE, 0)
+
+struct cosim_phase_t {
+	unsigned long long accesses;	// Video bus accesses
+	unsigned long long doodle;		// Of those, doodle core accesses
+	unsigned long long clocks;		// System clocks run
+	unsigned long frames;			// Frames started
+	unsigned long moves;			// Sprite moves committed
+	unsigned long long commit;		// Clocks from the moves' writes to their commits
+	unsigned long long commit_max;	// Longest of those
+};
+
+struct cosim_move_t {
+	int phase;						// Phase the move was written in
+	unsigned long long clock;		// Clock it was written on
+};
+
+static Vcosim_top *top;
+static unsigned long long cosim_clocks;					// System clocks since reset
+static cosim_phase_t cosim_phase[NUM_PHASES + 1];
+static cosim_move_t cosim_moves[COSIM_MOVES];			// Moves waiting for a frame tick
+static int cosim_pending;
+static uint16_t cosim_image[HOST_VMAX * HOST_HMAX];		// so_rgb of the frame being scanned
+static unsigned long cosim_frames;						// Frames scanned out
+static unsigned long cosim_dumped;
+static int cosim_dump_every = 60;
+static int cosim_steps = 300;
+static int cosim_step;									// Sprite moves so far
+static jmp_buf cosim_jump;								// Back to main() when the run ends
+static int cosim_pass = 1;
+
+static void cosim_halt()
+{
+	printf("stopped by the game's regression check at step %d, -v shows why\n", cosim_step);
+	cosim_pass = 0;
+	longjmp(cosim_jump, 1);
+}
+
+static int cosim_phase_index()
+{
+	return (perf_current >= 0) ? perf_current : COSIM_OTHER;
+}
+
+// Frame buffer pixel at x/y, its 9-bit color widened to 12 bits
+static uint16_t cosim_frame_rgb(int x, int y)
+{
+	if (x >= HOST_HMAX || y >= HOST_VMAX)
+		return 0;
+	if (host_frame_bypass)
+		return 0x008;		// Blue screen video_sys_daisy feeds the frame buffer core
+
+	uint32_t color = host_frame[y * HOST_HMAX + x];
+	uint16_t r = (color >> 6) & 0x7;
+	uint16_t g = (color >> 3) & 0x7;
+	uint16_t b = color & 0x7;
+
+	return ((r << 1 | r >> 2) << 8) | ((g << 1 | g >> 2) << 4) | (b << 1 | b >> 2);
+}
+
+// Write the scanned frame as a binary PPM
+static void cosim_dump()
+{
+	char name[64];
+	FILE *file;
+
+	snprintf(name, sizeof(name), COSIM_FRAME_DIR "/frame_%05lu.ppm", cosim_frames);
+	file = fopen(name, "wb");
+	if (!file) {
+		printf("cannot write %s\n", name);
+		return;
+	}
+
+	fprintf(file, "P6\n%d %d\n255\n", HOST_HMAX, HOST_VMAX);
+	for (int i = 0; i < HOST_VMAX * HOST_HMAX; i++) {
+		fputc(((cosim_image[i] >> 8) & 0xF) * 17, file);
+		fputc(((cosim_image[i] >> 4) & 0xF) * 17, file);
+		fputc((cosim_image[i] & 0xF) * 17, file);
+	}
+	fclose(file);
+	cosim_dumped++;
+}
+
+/**
+ * Run the RTL one system clock. Inputs set beforehand are
+ * sampled on its rising edge, then si_rgb follows the new
+ * scan position and the outputs are sampled
+ */
+
+static void cosim_tick()
+{
+	top->clk = 1;
+	top->eval();
+	top->si_rgb = cosim_frame_rgb(top->x, top->y);
+	top->clk = 0;
+	top->eval();
+
+	cosim_clocks++;
+	cosim_phase[cosim_phase_index()].clocks++;
+
+	// The core commits on the next rising edge
+	if (top->frame_tick) {
+		cosim_phase[cosim_phase_index()].frames++;
+		for (int i = 0; i < cosim_pending; i++) {
+			cosim_phase_t *phase_p = &cosim_phase[cosim_moves[i].phase];
+			unsigned long long clocks = cosim_clocks + 1 - cosim_moves[i].clock;
+
+			phase_p->moves++;
+			phase_p->commit += clocks;
+			if (clocks > phase_p->commit_max)
+				phase_p->commit_max = clocks;
+		}
+		cosim_pending = 0;
+	}
+
+	if (top->pixel_last) {
+		cosim_image[top->y * HOST_HMAX + top->x] = top->so_rgb;
+
+		if (top->x == HOST_HMAX - 1 && top->y == HOST_VMAX - 1) {
+			if (cosim_dump_every > 0 && cosim_frames % cosim_dump_every == 0)
+				cosim_dump();
+			cosim_frames++;
+		}
+	}
+}
+
+// Bring the RTL up to the simulated time, including the time of bus
+// accesses, the doodle core's access clocks count toward it
+static void cosim_time(unsigned long us)
+{
+	(void) us;
+
+	while (cosim_clocks < (unsigned long long) host_time * COSIM_CLOCKS_PER_US)
+		cosim_tick();
+}
+
+static int cosim_video(uint32_t base_addr)
+{
+	return base_addr >= COSIM_VIDEO_BASE && base_addr <= FRAME_BASE;
+}
+
+static void cosim_write(uint32_t base_addr, int offset, uint32_t data)
+{
+	if (!cosim_video(base_addr))
+		return;
+
+	int phase = cosim_phase_index();
+
+	// host_model.cpp charges the access time after this returns
+	cosim_phase[phase].accesses++;
+	if (base_addr != COSIM_DOODLE_BASE)
+		return;
+
+	cosim_phase[phase].doodle++;
+	cosim_time(0);
+	top->cs = 1;
+	top->write = 1;
+	top->addr = offset & 0x3FFF;
+	top->wr_data = data;
+	cosim_tick();
+	top->cs = 0;
+	top->write = 0;
+
+	if (offset == DoodleCore::XYC_REG) {
+		if (cosim_pending < COSIM_MOVES) {
+			cosim_moves[cosim_pending].phase = phase;
+			cosim_moves[cosim_pending].clock = cosim_clocks;
+			cosim_pending++;
+		}
+
+		if (++cosim_step == cosim_steps)
+			longjmp(cosim_jump, 1);
+	}
+}
+
+static int cosim_read(uint32_t base_addr, int offset, uint32_t *data)
+{
+	if (base_addr != COSIM_DOODLE_BASE)
+		return 0;
+
+	int phase = cosim_phase_index();
+
+	cosim_phase[phase].accesses++;
+	cosim_phase[phase].doodle++;
+	cosim_time(0);
+	top->cs = 1;
+	top->write = 0;
+	top->addr = offset & 0x3FFF;
+	top->eval();
+	*data = top->rd_data;
+	cosim_tick();
+	top->cs = 0;
+
+	return 1;
+}
+
+static void cosim_print()
+{
+	printf("%-8s %12s %12s %14s %8s %8s %12s %12s\n", "phase", "accesses", "doodle",
+			"clocks", "frames", "moves", "commit avg", "commit max");
+
+	for (int i = 0; i <= NUM_PHASES; i++) {
+		cosim_phase_t *phase_p = &cosim_phase[i];
+
+		printf("%-8s %12llu %12llu %14llu %8lu %8lu %12llu %12llu\n",
+				(i < NUM_PHASES) ? perf[i].name : "OTHER", phase_p->accesses, phase_p->doodle,
+				phase_p->clocks, phase_p->frames, phase_p->moves,
+				phase_p->moves ? phase_p->commit / phase_p->moves : 0, phase_p->commit_max);
+	}
+
+	printf("steps %d  frames %lu  dumped %lu  clocks %llu (%.1f ms)\n", cosim_step,
+			cosim_frames, cosim_dumped, cosim_clocks,
+			(double) cosim_clocks / (COSIM_CLOCKS_PER_US * 1000));
+}
+
+int main(int argc, char **argv)
+{
+	Verilated::commandArgs(argc, argv);
+
+	host_uart_file = 0;
+	input_source = &replay_input;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-a") == 0)
+			input_source = &autopilot_input;
+		else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+			cosim_steps = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+			cosim_dump_every = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-v") == 0)
+			host_uart_file = stdout;
+	}
+
+	if (cosim_dump_every > 0)
+		mkdir(COSIM_FRAME_DIR, 0777);
+
+	top = new Vcosim_top;
+	top->reset = 1;
+	top->cs = 0;
+	top->write = 0;
+	top->clk = 0;
+	top->eval();
+	top->reset = 0;
+	top->eval();
+
+	host_write_hook = cosim_write;
+	host_read_hook = cosim_read;
+	host_time_hook = cosim_time;
+
+	if (setjmp(cosim_jump) == 0)
+		doodle_main();
+
+	cosim_print();
+
+	top->final();
+	delete top;
+
+	return cosim_pass ? 0 : 1;
+}
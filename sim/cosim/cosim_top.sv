@@ -0,0 +1,88 @@
+// Co-simulation top for the doodle sprite core
+//
+//   * the core as instantiated in video_sys_daisy, with its bus
+//     brought out to the bus-functional model in cosim.cpp
+//   * a 640x480 scan with blanking (800x525 at one pixel every
+//     4 clocks of the 100 MHz system clock), standing in for
+//     frame_counter and the sync core, which are not in this tree
+//   * si_rgb is supplied by cosim.cpp from the frame buffer model
+//
+// Built with Verilator by "make cosim" in sim/
+
+module cosim_top
+   #(
+    parameter INIT_FILE = "../doodle_bitmap.txt"   // sprite bitmap, relative to sim/
+   )
+   (
+    input  logic clk, reset,
+    // video slot interface of the doodle core
+    input  logic cs,
+    input  logic write,
+    input  logic [13:0] addr,
+    input  logic [31:0] wr_data,
+    output logic [31:0] rd_data,
+    // scan position, and the frame buffer pixel at it
+    output logic [10:0] x, y,
+    input  logic [11:0] si_rgb,
+    // pixel output
+    output logic pixel_last,   // last clock of a visible pixel, so_rgb has settled
+    output logic frame_tick,   // clock the core commits x0/y0/ctrl
+    output logic [11:0] so_rgb
+   );
+
+   // localparam declaration
+   localparam [10:0] H_TOTAL = 800;
+   localparam [10:0] V_TOTAL = 525;
+   localparam [10:0] HMAX = 640;
+   localparam [10:0] VMAX = 480;
+   // signal declaration
+   logic [1:0] div_reg;
+   logic [10:0] h_reg, v_reg;
+   logic frame_start, frame_start_d1_reg;
+
+   // body
+   // pixel counters, x/y are held for the 4 clocks of each pixel
+   always_ff @(posedge clk, posedge reset)
+      if (reset) begin
+         div_reg <= 2'd0;
+         h_reg <= 11'd0;
+         v_reg <= 11'd0;
+         frame_start_d1_reg <= 1'b0;
+      end
+      else begin
+         div_reg <= div_reg + 2'd1;
+         if (div_reg == 2'd3) begin
+            if (h_reg == H_TOTAL - 11'd1) begin
+               h_reg <= 11'd0;
+               v_reg <= (v_reg == V_TOTAL - 11'd1) ? 11'd0 : v_reg + 11'd1;
+            end
+            else
+               h_reg <= h_reg + 11'd1;
+         end
+         frame_start_d1_reg <= frame_start;
+      end
+   assign x = h_reg;
+   assign y = v_reg;
+   assign frame_start = (h_reg == 11'd0) && (v_reg == 11'd0);
+   assign pixel_last = (div_reg == 2'd3) && (h_reg < HMAX) && (v_reg < VMAX);
+   // same edge the core latches its shadow registers on
+   assign frame_tick = frame_start && ~frame_start_d1_reg;
+
+   // instantiate the doodle sprite core
+   chu_vga_sprite_doodle_core
+       #(.CD(12), .ADDR_WIDTH(13), .KEY_COLOR(0), .INIT_FILE(INIT_FILE))
+   doodle_unit (
+      .clk(clk),
+      .reset(reset),
+      .x(x),
+      .y(y),
+      .frame_start(frame_start),
+      .cs(cs),
+      .write(write),
+      .addr(addr),
+      .wr_data(wr_data),
+      .rd_data(rd_data),
+      .si_rgb(si_rgb),
+      .so_rgb(so_rgb)
+   );
+endmodule
@@ -0,0 +1,22 @@
+/*
+ * chu_init.h
+ *
+ *  Host stand-in for the FPro system header. Time is simulated: it
+ *  only advances when the program asks for it, see host_model.h
+ */
+
+#ifndef _CHU_INIT_H_INCLUDED
+#define _CHU_INIT_H_INCLUDED
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "chu_io_map.h"
+#include "io_rw.h"
+#include "uart_core.h"
+
+unsigned long now_us();
+unsigned long now_ms();
+void sleep_us(int us);
+void sleep_ms(int ms);
+
+#endif
@@ -0,0 +1,30 @@
+/*
+ * chu_io_map.h
+ *
+ *  Host stand-in for the FPro address map, only the slots the game uses
+ */
+
+#ifndef _CHU_IO_MAP_INCLUDED
+#define _CHU_IO_MAP_INCLUDED
+
+#define BRIDGE_BASE 0xc0000000
+
+// MMIO slots
+#define S0_SYS_TIMER 0
+#define S1_UART1 1
+#define S5_XDAC 5
+#define S11_PS2 11
+
+// Video slots
+#define V0_SYNC 0
+#define V1_MOUSE 1
+#define V2_OSD 2
+#define V3_GHOST 3
+#define V4_USER4 4
+#define V5_USER5 5
+#define V6_GRAY 6
+#define V7_BG 7
+
+#define FRAME_BASE get_sprite_addr(BRIDGE_BASE, V7_BG)
+
+#endif
@@ -0,0 +1,12 @@
+/*
+ * gpio_cores.h
+ *
+ *  Host stand-in for the FPro GPIO drivers, the game uses none of them
+ */
+
+#ifndef _GPIO_CORES_H_INCLUDED
+#define _GPIO_CORES_H_INCLUDED
+
+#include "chu_init.h"
+
+#endif
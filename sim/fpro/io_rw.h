@@ -0,0 +1,24 @@
+/*
+ * io_rw.h
+ *
+ *  Host stand-in for the FPro bus access macros. Every access goes to
+ *  the model in host_model.cpp instead of the MicroBlaze IO bus.
+ */
+
+#ifndef _IO_RW_H_INCLUDED
+#define _IO_RW_H_INCLUDED
+
+#include <stdint.h>
+
+// Bus access, offset is in 32-bit words as on the board
+uint32_t host_io_read(uint32_t base_addr, int offset);
+void host_io_write(uint32_t base_addr, int offset, uint32_t data);
+
+#define io_read(base_addr, offset) host_io_read((base_addr), (offset))
+#define io_write(base_addr, offset, data) host_io_write((base_addr), (offset), (data))
+
+// Slot addresses, each MMIO slot has 32 words and each video slot 0x4000 words
+#define get_slot_addr(mmio_base, slot) ((uint32_t)((mmio_base) + (slot) * 32 * 4))
+#define get_sprite_addr(mmio_base, slot) ((uint32_t)((mmio_base) + 0x00c00000 + (slot) * 0x4000 * 4))
+
+#endif
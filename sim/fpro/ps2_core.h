@@ -0,0 +1,26 @@
+/*
+ * ps2_core.h
+ *
+ *  Host stand-in for the FPro PS/2 driver, received bytes come from
+ *  host_ps2_push()
+ */
+
+#ifndef _PS2_CORE_H_INCLUDED
+#define _PS2_CORE_H_INCLUDED
+
+#include "chu_init.h"
+
+class Ps2Core {
+public:
+	Ps2Core(uint32_t core_base_addr);
+	int rx_fifo_empty();
+	int rx_byte();
+	int tx_byte(uint8_t cmd);
+	int init();
+	int get_kb_ch(char *ch);
+
+private:
+	uint32_t base_addr;
+};
+
+#endif
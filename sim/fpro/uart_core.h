@@ -0,0 +1,29 @@
+/*
+ * uart_core.h
+ *
+ *  Host stand-in for the FPro UART driver, output goes to host_uart_file
+ */
+
+#ifndef _UART_CORE_H_INCLUDED
+#define _UART_CORE_H_INCLUDED
+
+#include <stdint.h>
+
+class UartCore {
+public:
+	UartCore(uint32_t core_base_addr);
+	void disp(char ch);
+	void disp(const char *str);
+	void disp(int n, int base, int len);
+	void disp(int n, int base);
+	void disp(int n);
+	void disp(double f, int digit);
+	void disp(double f);
+
+private:
+	uint32_t base_addr;
+};
+
+extern UartCore uart;
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * vga_core.h
+ *
+ *  Host stand-in for the FPro video drivers. The drivers issue the same
+ *  bus writes as on the board, the model in host_model.cpp keeps the
+ *  frame buffer, tiles and registers they write
+ */
+
+#ifndef _VGA_CORE_H_INCLUDED
+#define _VGA_CORE_H_INCLUDED
+
+#include "chu_init.h"
+
+class FrameCore {
+public:
+	enum {
+		HMAX = 640,
+		VMAX = 480,
+		BYPASS_REG = 0x7FFFF		// last word of the frame buffer space, past the 640x480 pixels
+	};
+
+	FrameCore(uint32_t frame_base_addr);
+	void wr_pix(int x, int y, int color);
+	void clr_screen(int color);
+	void bypass(int on);
+
+private:
+	uint32_t base_addr;
+};
+
+class SpriteCore {
+public:
+	enum {
+		BYPASS_REG = 0x2000,
+		X_REG = 0x2001,
+		Y_REG = 0x2002,
+		SPRITE_CTRL_REG = 0x2003
+	};
+
+	SpriteCore(uint32_t core_base_addr, int sprite_size);
+	void wr_mem(int addr, uint32_t color);
+	void move_xy(int x, int y);
+	void wr_ctrl(int32_t cmd);
+	void bypass(int on);
+
+private:
+	uint32_t base_addr;
+	int size;
+};
+
+class OsdCore {
+public:
+	enum {
+		BYPASS_REG = 0x2000,
+		FG_CLR_REG = 0x2001,
+		BG_CLR_REG = 0x2002,
+		CHAR_X_MAX = 80,
+		CHAR_Y_MAX = 30
+	};
+
+	OsdCore(uint32_t core_base_addr);
+	void set_color(uint32_t fg_color, uint32_t bg_color);
+	void wr_char(uint8_t x, uint8_t y, char ch, int reverse = 0);
+	void clr_screen();
+	void bypass(int on);
+
+private:
+	uint32_t base_addr;
+};
+
+#endif
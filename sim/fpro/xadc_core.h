@@ -0,0 +1,22 @@
+/*
+ * xadc_core.h
+ *
+ *  Host stand-in for the FPro XADC driver, every channel reads
+ *  host_adc_volts
+ */
+
+#ifndef _XADC_CORE_H_INCLUDED
+#define _XADC_CORE_H_INCLUDED
+
+#include "chu_init.h"
+
+class XadcCore {
+public:
+	XadcCore(uint32_t core_base_addr);
+	double read_adc_in(int n);
+
+private:
+	uint32_t base_addr;
+};
+
+#endif
@@ -0,0 +1,351 @@
+/*
+ * host_model.cpp
+ *
+ *  Model of the FPro SoC the game runs on, see host_model.h
+ */
+
+#include <string.h>
+#include "chu_init.h"
+#include "vga_core.h"
+#include "ps2_core.h"
+#include "xadc_core.h"
+#include "host_model.h"
+
+#define HOST_VIDEO_BASE get_sprite_addr(BRIDGE_BASE, 0)
+#define HOST_SLOT_BYTES (0x4000 * 4)
+#define HOST_PS2_SIZE 256
+
+uint32_t host_frame[HOST_VMAX * HOST_HMAX];
+uint32_t host_frame_bypass;
+uint32_t host_video[HOST_VIDEO_SLOTS][HOST_SLOT_WORDS];
+unsigned long host_time;
+unsigned long host_writes;
+FILE *host_uart_file = stdout;
+int host_ps2_id = 1;
+double host_adc_volts = 0.5;
+
+void (*host_write_hook)(uint32_t base_addr, int offset, uint32_t data) = 0;
+int (*host_read_hook)(uint32_t base_addr, int offset, uint32_t *data) = 0;
+void (*host_time_hook)(unsigned long us) = 0;
+
+static unsigned long host_access_ns;		// Bus access time not yet a whole microsecond
+static int host_ps2_fifo[HOST_PS2_SIZE];
+static unsigned int host_ps2_head;
+static unsigned int host_ps2_tail;
+
+UartCore uart(get_slot_addr(BRIDGE_BASE, S1_UART1));
+
+/**********************************************************************
+ * Model
+ *********************************************************************/
+
+void host_reset()
+{
+	memset(host_frame, 0, sizeof(host_frame));
+	memset(host_video, 0, sizeof(host_video));
+	host_frame_bypass = 0;
+	host_time = 0;
+	host_access_ns = 0;
+	host_writes = 0;
+	host_ps2_head = 0;
+	host_ps2_tail = 0;
+}
+
+void host_advance(unsigned long us)
+{
+	host_time += us;
+	if (host_time_hook)
+		host_time_hook(us);
+}
+
+void host_ps2_push(int code)
+{
+	if (host_ps2_head - host_ps2_tail < HOST_PS2_SIZE)
+		host_ps2_fifo[host_ps2_head++ % HOST_PS2_SIZE] = code;
+}
+
+// Charge one bus access to simulated time
+static void host_access()
+{
+	host_access_ns += HOST_ACCESS_NS;
+	if (host_access_ns >= 1000) {
+		host_advance(host_access_ns / 1000);
+		host_access_ns %= 1000;
+	}
+}
+
+uint32_t host_frame_count()
+{
+	return host_time / HOST_FRAME_US;
+}
+
+unsigned int host_hash()
+{
+	unsigned int hash = 2166136261u;
+
+	for (int i = 0; i < HOST_VMAX * HOST_HMAX; i++)
+		hash = (hash ^ host_frame[i]) * 16777619u;
+	hash = (hash ^ host_frame_bypass) * 16777619u;
+
+	for (int slot = 0; slot < HOST_VIDEO_SLOTS; slot++) {
+		for (int i = 0; i < HOST_SLOT_WORDS; i++)
+			hash = (hash ^ host_video[slot][i]) * 16777619u;
+	}
+
+	return hash;
+}
+
+/**********************************************************************
+ * Bus
+ *********************************************************************/
+
+static uint32_t host_read(uint32_t base_addr, int offset)
+{
+	uint32_t data;
+
+	if (host_read_hook && host_read_hook(base_addr, offset, &data))
+		return data;
+
+	// Video slot registers, 0x2000 reads the frame counter of the doodle core
+	if (base_addr >= HOST_VIDEO_BASE && base_addr < FRAME_BASE) {
+		if (offset == 0x2000)
+			return host_frame_count();
+		if (offset >= 0 && offset < HOST_SLOT_WORDS)
+			return host_video[(base_addr - HOST_VIDEO_BASE) / HOST_SLOT_BYTES][offset];
+	}
+
+	return 0;
+}
+
+uint32_t host_io_read(uint32_t base_addr, int offset)
+{
+	uint32_t data = host_read(base_addr, offset);
+
+	host_access();
+	return data;
+}
+
+void host_io_write(uint32_t base_addr, int offset, uint32_t data)
+{
+	host_writes++;
+
+	if (base_addr == FRAME_BASE) {
+		if (offset == FrameCore::BYPASS_REG)
+			host_frame_bypass = data;
+		else if (offset >= 0 && offset < HOST_VMAX * HOST_HMAX)
+			host_frame[offset] = data;
+	}
+	else if (base_addr >= HOST_VIDEO_BASE && base_addr < FRAME_BASE) {
+		uint32_t *slot = host_video[(base_addr - HOST_VIDEO_BASE) / HOST_SLOT_BYTES];
+
+		if (offset == 0x2004) {
+			// Doodle core x, y and ctrl in one write
+			slot[0x2001] = data & 0x7FF;
+			slot[0x2002] = (data >> 11) & 0x7FF;
+			slot[0x2003] = (data >> 22) & 0x3F;
+		}
+		else if (offset >= 0 && offset < HOST_SLOT_WORDS)
+			slot[offset] = data;
+	}
+
+	if (host_write_hook)
+		host_write_hook(base_addr, offset, data);
+	host_access();
+}
+
+/**********************************************************************
+ * Time
+ *********************************************************************/
+
+unsigned long now_us()
+{
+	host_advance(1);
+	return host_time;
+}
+
+unsigned long now_ms()
+{
+	return now_us() / 1000;
+}
+
+void sleep_us(int us)
+{
+	host_advance(us);
+}
+
+void sleep_ms(int ms)
+{
+	host_advance((unsigned long) ms * 1000);
+}
+
+/**********************************************************************
+ * Drivers
+ *********************************************************************/
+
+UartCore::UartCore(uint32_t core_base_addr) : base_addr(core_base_addr) {}
+
+void UartCore::disp(char ch)
+{
+	if (host_uart_file)
+		fputc(ch, host_uart_file);
+}
+
+void UartCore::disp(const char *str)
+{
+	while (*str)
+		disp(*str++);
+}
+
+void UartCore::disp(int n, int base, int len)
+{
+	char buf[33];
+	unsigned int un = (n < 0 && base == 10) ? -n : n;
+	int i = 0;
+
+	do {
+		int digit = un % base;
+		buf[i++] = (digit < 10) ? '0' + digit : 'a' + digit - 10;
+		un /= base;
+	} while (un != 0 && i < 32);
+
+	while (i < len && i < 32)
+		buf[i++] = (base == 10) ? ' ' : '0';
+	if (n < 0 && base == 10)
+		disp('-');
+	while (i > 0)
+		disp(buf[--i]);
+}
+
+void UartCore::disp(int n, int base)
+{
+	disp(n, base, 0);
+}
+
+void UartCore::disp(int n)
+{
+	disp(n, 10, 0);
+}
+
+void UartCore::disp(double f, int digit)
+{
+	char buf[64];
+
+	snprintf(buf, sizeof(buf), "%.*f", digit, f);
+	disp(buf);
+}
+
+void UartCore::disp(double f)
+{
+	disp(f, 3);
+}
+
+FrameCore::FrameCore(uint32_t frame_base_addr) : base_addr(frame_base_addr) {}
+
+void FrameCore::wr_pix(int x, int y, int color)
+{
+	io_write(base_addr, y * HMAX + x, color);
+}
+
+void FrameCore::clr_screen(int color)
+{
+	for (int y = 0; y < VMAX; y++) {
+		for (int x = 0; x < HMAX; x++)
+			wr_pix(x, y, color);
+	}
+}
+
+void FrameCore::bypass(int on)
+{
+	io_write(base_addr, BYPASS_REG, (uint32_t) on);
+}
+
+SpriteCore::SpriteCore(uint32_t core_base_addr, int sprite_size) :
+	base_addr(core_base_addr), size(sprite_size) {}
+
+void SpriteCore::wr_mem(int addr, uint32_t color)
+{
+	io_write(base_addr, addr, color);
+}
+
+void SpriteCore::move_xy(int x, int y)
+{
+	io_write(base_addr, X_REG, x);
+	io_write(base_addr, Y_REG, y);
+}
+
+void SpriteCore::wr_ctrl(int32_t cmd)
+{
+	io_write(base_addr, SPRITE_CTRL_REG, cmd);
+}
+
+void SpriteCore::bypass(int on)
+{
+	io_write(base_addr, BYPASS_REG, (uint32_t) on);
+}
+
+OsdCore::OsdCore(uint32_t core_base_addr) : base_addr(core_base_addr) {}
+
+void OsdCore::set_color(uint32_t fg_color, uint32_t bg_color)
+{
+	io_write(base_addr, FG_CLR_REG, fg_color);
+	io_write(base_addr, BG_CLR_REG, bg_color);
+}
+
+void OsdCore::wr_char(uint8_t x, uint8_t y, char ch, int reverse)
+{
+	uint32_t data = (ch & 0x7F) | (reverse ? 0x80 : 0);
+
+	io_write(base_addr, (y << 7) + x, data);
+}
+
+void OsdCore::clr_screen()
+{
+	for (int y = 0; y < CHAR_Y_MAX; y++) {
+		for (int x = 0; x < CHAR_X_MAX; x++)
+			wr_char(x, y, 0x00);
+	}
+}
+
+void OsdCore::bypass(int on)
+{
+	io_write(base_addr, BYPASS_REG, (uint32_t) on);
+}
+
+Ps2Core::Ps2Core(uint32_t core_base_addr) : base_addr(core_base_addr) {}
+
+int Ps2Core::rx_fifo_empty()
+{
+	return host_ps2_head == host_ps2_tail;
+}
+
+int Ps2Core::rx_byte()
+{
+	if (rx_fifo_empty())
+		return -1;
+	return host_ps2_fifo[host_ps2_tail++ % HOST_PS2_SIZE];
+}
+
+int Ps2Core::tx_byte(uint8_t cmd)
+{
+	(void) cmd;
+	return 0;
+}
+
+int Ps2Core::init()
+{
+	return host_ps2_id;
+}
+
+int Ps2Core::get_kb_ch(char *ch)
+{
+	(void) ch;
+	return 0;
+}
+
+XadcCore::XadcCore(uint32_t core_base_addr) : base_addr(core_base_addr) {}
+
+double XadcCore::read_adc_in(int n)
+{
+	(void) n;
+	return host_adc_volts;
+}
@@ -0,0 +1,56 @@
+/*
+ * host_model.h
+ *
+ *  Model of the FPro SoC the game runs on, for building doodle_game.cpp
+ *  on a host against the stand-in headers in fpro/. Bus writes land in
+ *  a frame buffer and video slot arrays, so a run can be hashed pixel
+ *  for pixel
+ *
+ *  @note: Time is simulated. It advances 1 us on every now_us() call,
+ *  		HOST_ACCESS_NS on every bus access and by the full amount
+ *  		on a sleep, so busy waits finish without taking host time
+ */
+
+#ifndef _HOST_MODEL_H_INCLUDED
+#define _HOST_MODEL_H_INCLUDED
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define HOST_HMAX 640
+#define HOST_VMAX 480
+#define HOST_VIDEO_SLOTS 8
+#define HOST_SLOT_WORDS (0x2000 + 8)		// Memory below 0x2000, registers above
+#define HOST_FRAME_US 16800					// Simulated time of one 800x525 frame at 25 MHz
+#define HOST_ACCESS_NS 250					// Simulated time of one bus access, WRITE_NS in doodle_game.cpp
+
+extern uint32_t host_frame[HOST_VMAX * HOST_HMAX];					// Frame buffer pixels
+extern uint32_t host_frame_bypass;									// Frame buffer bypass register
+extern uint32_t host_video[HOST_VIDEO_SLOTS][HOST_SLOT_WORDS];		// Sprite and OSD memories and registers
+extern unsigned long host_time;			// Simulated time in microseconds
+extern unsigned long host_writes;		// Bus writes issued
+extern FILE *host_uart_file;			// UART output, 0 to drop it
+extern int host_ps2_id;					// Ps2Core::init() result, 1 for a keyboard
+extern double host_adc_volts;			// Voltage every XADC channel reads
+
+// Optional hooks, 0 when unused
+extern void (*host_write_hook)(uint32_t base_addr, int offset, uint32_t data);	// After every bus write
+extern int (*host_read_hook)(uint32_t base_addr, int offset, uint32_t *data);	// Returns 1 if it supplied the data
+extern void (*host_time_hook)(unsigned long us);								// After simulated time advances
+
+// Clear the model to its power on state
+void host_reset();
+
+// Advance simulated time
+void host_advance(unsigned long us);
+
+// Queue a byte as if received from the keyboard
+void host_ps2_push(int code);
+
+// Frames shown since reset
+uint32_t host_frame_count();
+
+// FNV-1a hash of the frame buffer and every video slot
+unsigned int host_hash();
+
+#endif
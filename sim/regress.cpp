@@ -0,0 +1,273 @@
+/*
+ * regress.cpp
+ *
+ *  Regression suite for doodle_game.cpp, built on a host against the
+ *  FPro model in host_model.cpp. Each scenario plays the game from
+ *  power on with an unattended input source and, at set steps, hashes
+ *  the whole frame buffer, OSD and sprite registers against a known
+ *  good run. Bus writes and simulated time are held to the known good
+ *  run too, and the game's performance budgets are checked at each
+ *  game over
+ *
+ *  @note: The replay_checks_game goldens are not applied. They hash
+ *  		the writes, not the screen, so a renderer optimization that
+ *  		draws the same pixels with fewer writes would fail them
+ *
+ *  Usage: regress [-g] [-v]
+ *  	-g	print this build's hashes and write counts, in the form of the
+ *  		tables below and replay_checks_game, to record a new known
+ *  		good run
+ *  	-v	show the game's UART output
+ *
+ *  @note: Exits with 1 if any scenario fails
+ */
+
+#include <setjmp.h>
+#include <string.h>
+#include <chrono>
+#include "host_model.h"
+
+static void regress_halt();
+
+#define REGRESSION_HALT() regress_halt()
+#define main doodle_main
+#include "../doodle_game.cpp"
+#undef main
+
+#define NUM_ITEMS(array) ((int) (sizeof(array) / sizeof(array[0])))
+
+struct regress_check_t {
+	int step;				// Sprite moves since power on
+	unsigned int hash;		// host_hash() of the known good run at that step
+};
+
+struct regress_scenario_t {
+	const char *name;
+	InputSource *input_p;
+	int pause_step;					// Step 'P' then 'U' are typed on, -1 for none
+	const regress_check_t *checks;
+	int num_checks;
+	unsigned long max_writes;		// Bus writes allowed up to the last check
+	unsigned long max_us;			// Simulated time allowed up to the last check
+};
+
+// Known good runs, recorded with -g
+// @note: Step 0 is the first sprite move, with the title, grid and platforms
+//		drawn. The replay falls out of bounds after step 1049 and restarts,
+//		step 1050 matching step 0 shows the restart leaves nothing behind
+static const regress_check_t replay_checks[] = {
+	{0, 0xca12b0feu},
+	{65, 0xec8ebcf3u},
+	{601, 0x1dddafa7u},
+	{1049, 0x5dc8e807u},
+	{1050, 0xca12b0feu},
+	{1200, 0x0623d75eu},
+	{2300, 0x34ea54b7u}
+};
+
+static const regress_check_t autopilot_checks[] = {
+	{0, 0xca12b0feu},
+	{1000, 0x7b56d925u},
+	{5000, 0x852cb3f1u},
+	{20000, 0x706ed952u}
+};
+
+// @note: The pause is typed during step 50 and shown and cleared on step 51
+static const regress_check_t pause_checks[] = {
+	{50, 0xc7597270u},
+	{51, 0xd47830fcu},
+	{300, 0x9ef38f29u}
+};
+
+// Write and time limits are the known good counts, so any extra bus write
+// or simulated microsecond fails. Lower them with the change that saves them
+// @note: Simulated time charges HOST_ACCESS_NS per bus access and 1 us per
+//		now_us() call, so a renderer that polls or writes more is slower
+// @note: -g records replay_checks_game from the first scenario
+static const regress_scenario_t scenarios[] = {
+	{"replay", &replay_input, -1, replay_checks, NUM_ITEMS(replay_checks), 1442802, 26557421},
+	{"autopilot", &autopilot_input, -1, autopilot_checks, NUM_ITEMS(autopilot_checks), 1131874, 200418264},
+	{"pause", &replay_input, 50, pause_checks, NUM_ITEMS(pause_checks), 506952, 3119250}
+};
+
+static jmp_buf regress_jump;				// Back to regress_run() when a scenario ends
+static const regress_scenario_t *regress_p;	// Scenario being run
+static int regress_step;					// Sprite moves so far
+static int regress_check;					// Next check
+static int regress_pass;
+static int regress_golden;					// Printing a new known good run
+
+/**
+ * Replay that records state_hash() at the steps of replay_checks_game,
+ * used in place of replay_input with -g
+ */
+
+class RegressRecord : public ReplayInput {
+public:
+	RegressRecord() : ReplayInput(replay_script, NUM_ITEMS(replay_script)), played(0), check(0)
+	{
+		memset(hashes, 0, sizeof(hashes));
+	}
+
+	int direction()
+	{
+		if (check < NUM_ITEMS(replay_checks_game) && replay_checks_game[check].step == played)
+			hashes[check++] = state_hash();
+
+		played++;
+		return ReplayInput::direction();
+	}
+
+	void print()
+	{
+		printf("replay_checks_game:\n");
+		for (int i = 0; i < check; i++)
+			printf("\t{%d, 0x%08xu},\n", replay_checks_game[i].step, hashes[i]);
+	}
+
+private:
+	int played;
+	int check;
+	unsigned int hashes[NUM_ITEMS(replay_checks_game)];
+};
+
+static RegressRecord regress_record;
+
+static void regress_halt()
+{
+	printf("%s: stopped by the game's regression check at step %d, -v shows why\n",
+			regress_p->name, regress_step);
+	regress_pass = 0;
+	longjmp(regress_jump, 1);
+}
+
+// Type a key, as the make and break codes the keyboard sends
+static void regress_key(int code)
+{
+	host_ps2_push(code);
+	host_ps2_push(0xF0);
+	host_ps2_push(code);
+}
+
+static void regress_write(uint32_t base_addr, int offset, uint32_t data)
+{
+	(void) data;
+
+	if (base_addr != get_sprite_addr(BRIDGE_BASE, V5_USER5) || offset != DoodleCore::XYC_REG)
+		return;
+
+	if (regress_step == regress_p->pause_step) {
+		regress_key(0x4D);		// P
+		regress_key(0x3C);		// U
+	}
+
+	if (regress_step == regress_p->checks[regress_check].step) {
+		unsigned int hash = host_hash();
+
+		if (regress_golden)
+			printf("\t{%d, 0x%08xu},\n", regress_step, hash);
+		else if (hash != regress_p->checks[regress_check].hash) {
+			printf("%s: step %d hash %08x, expected %08x\n", regress_p->name,
+					regress_step, hash, regress_p->checks[regress_check].hash);
+			regress_pass = 0;
+		}
+
+		if (++regress_check == regress_p->num_checks)
+			longjmp(regress_jump, 1);
+	}
+
+	regress_step++;
+}
+
+// Put the game and the model back to power on
+static void regress_reset(const regress_scenario_t *scenario_p)
+{
+	host_reset();
+
+	background_drawn = 0;
+	keyboard_checked = 0;
+	score = 0;
+	platform_seed = 1;
+	key_head = 0;
+	key_tail = 0;
+	key_ps2_p = 0;
+	for (int i = 0; i < NUM_LATENCY; i++)
+		latency_count[i] = 0;
+	steer_pending = 0;
+
+	perf_current = -1;
+	perf_hash = 0;
+	for (int i = 0; i < NUM_PHASES; i++) {
+		perf[i].units = 0;
+		perf[i].writes = 0;
+		perf[i].us = 0;
+	}
+
+	replay_input = ReplayInput(replay_script, NUM_ITEMS(replay_script));
+	regress_record = RegressRecord();
+
+	input_source = scenario_p->input_p;
+	if (regress_golden && scenario_p == &scenarios[0])
+		input_source = &regress_record;
+}
+
+static int regress_run(const regress_scenario_t *scenario_p)
+{
+	regress_p = scenario_p;
+	regress_step = 0;
+	regress_check = 0;
+	regress_pass = 1;
+	regress_reset(scenario_p);
+
+	if (regress_golden)
+		printf("%s:\n", scenario_p->name);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	if (setjmp(regress_jump) == 0)
+		doodle_main();
+
+	double ms = std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now() - start).count();
+
+	if (regress_golden) {
+		printf("\twrites %lu, %lu us, %.0f ms\n", host_writes, host_time, ms);
+		if (scenario_p == &scenarios[0])
+			regress_record.print();
+		return 1;
+	}
+
+	if (host_writes > scenario_p->max_writes) {
+		printf("%s: %lu bus writes, limit %lu\n", scenario_p->name, host_writes, scenario_p->max_writes);
+		regress_pass = 0;
+	}
+	if (host_time > scenario_p->max_us) {
+		printf("%s: %lu us simulated, limit %lu\n", scenario_p->name, host_time, scenario_p->max_us);
+		regress_pass = 0;
+	}
+
+	printf("%-10s %s  steps %d  writes %lu  %lu us  %.0f ms\n", scenario_p->name,
+			regress_pass ? "PASS" : "FAIL", regress_step, host_writes, host_time, ms);
+
+	return regress_pass;
+}
+
+int main(int argc, char **argv)
+{
+	int pass = 1;
+
+	host_uart_file = 0;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-g") == 0)
+			regress_golden = 1;
+		else if (strcmp(argv[i], "-v") == 0)
+			host_uart_file = stdout;
+	}
+
+	host_write_hook = regress_write;
+
+	for (int i = 0; i < NUM_ITEMS(scenarios); i++)
+		pass &= regress_run(&scenarios[i]);
+
+	return pass ? 0 : 1;
+}
@@ -20,7 +20,8 @@
 module video_sys_daisy 
 #(
    parameter CD = 12,            // color depth
-   parameter VRAM_DATA_WIDTH = 9 //frame buffer data width
+   parameter VRAM_DATA_WIDTH = 9, //frame buffer data width
+   parameter DOODLE_INIT_FILE = "doodle_bitmap.txt" // doodle sprite bitmap
 )
 (
    input logic clk_sys,
@@ -31,6 +32,7 @@ module video_sys_daisy
    input logic video_wr,
    input logic [20:0] video_addr, 
    input logic [31:0] video_wr_data,
+   output logic [31:0] video_rd_data,
    // to vga monitor  
    output logic vsync, hsync,
    output logic [11:0] rgb 
@@ -57,6 +59,8 @@ module video_sys_daisy
    logic [7:0] slot_mem_wr_array;
    logic [13:0] slot_reg_addr_array [7:0];
    logic [31:0] slot_wr_data_array [7:0];
+   // doodle sprite read out (frame counter)
+   logic [31:0] doodle_rd_data;
    
    // 2-stage delay line for start signal
    always_ff @(posedge clk_sys) begin
@@ -127,16 +131,18 @@ module video_sys_daisy
    );
    // instantiate user unit 5, used for doodle sprite
    chu_vga_sprite_doodle_core
-       #(.CD(CD), .ADDR_WIDTH(10), .KEY_COLOR(KEY_COLOR)) 
+       #(.CD(CD), .ADDR_WIDTH(13), .KEY_COLOR(KEY_COLOR), .INIT_FILE(DOODLE_INIT_FILE)) 
    v5_user_unit (
       .clk(clk_sys),
       .reset(reset_sys),
       .x(x),
       .y(y),
+      .frame_start(frame_start),
       .cs(slot_cs_array[`V5_USER5]),
       .write(slot_mem_wr_array[`V5_USER5]),
       .addr(slot_reg_addr_array[`V5_USER5]),
       .wr_data(slot_wr_data_array[`V5_USER5]),
+      .rd_data(doodle_rd_data),
       .si_rgb(gray_rgb6),
       .so_rgb(doodle_rgb5)
    );
@@ -194,6 +200,9 @@ module video_sys_daisy
       .si_rgb(osd_rgb2),
       .so_rgb(mouse_rgb1)
    );
+   // only the doodle sprite core has readable registers,
+   // every other slot and the frame buffer read as 0
+   assign video_rd_data = (slot_cs_array[`V5_USER5]) ? doodle_rd_data : 32'h0;
    // merge start signal to rgb data stream
    assign line_data_in = {mouse_rgb1, frame_start_d2_reg};
    // instantiate sync_core